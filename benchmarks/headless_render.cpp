@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <chrono>
+#include <core/headless.hpp>
+#include <fmt/format.h>
+#include <memory>
+#include <rebuildtui.hpp>
+#include <string>
+#include <ui/section_builder.hpp>
+
+using namespace tui;
+
+// Renders a scripted session into the in-memory backend, no TTY needed.
+// Usage: bench_headless_render [items] [keys] [colors: 16, 256 or 24 for truecolor]
+int main(const int argc, char** argv) {
+    const int item_count = argc > 1 ? std::stoi(argv[1]) : 10000;
+    const int key_count = argc > 2 ? std::stoi(argv[2]) : 2000;
+    const int colors = argc > 3 ? std::stoi(argv[3]) : 24;
+
+    auto packages = SectionBuilder("Packages").description("Packages rebuilt from source");
+    for (int i = 0; i < item_count; ++i) {
+        packages.add_item(fmt::format("package-{:05}", i),
+                          fmt::format("Package number {} — rebuilt from source with LTO and PGO", i));
+    }
+
+    auto backend = std::make_shared<HeadlessBackend>(50, 160);
+    backend->set_recording(false);
+    backend->set_color_depth(colors == 16    ? ColorDepth::ANSI16
+                                 : colors == 256 ? ColorDepth::INDEXED256
+                                                 : ColorDepth::TRUECOLOR);
+
+    // Enter the section, walk down toggling every fifth item, page through, leave
+    backend->push_key(Key::ENTER);
+    for (int i = 0; i < key_count; ++i) {
+        backend->push_key(i % 5 == 4 ? Key::SPACE : Key::ARROW_DOWN);
+    }
+    for (int i = 0; i < key_count / 10; ++i) {
+        backend->push_key(Key::ARROW_RIGHT);
+    }
+    backend->push_keys("q");
+
+    auto tui = NavigationBuilder()
+                   .theme_gradient_support(true)
+                   .theme_gradient_preset(extras::GradientPreset::RAINBOW())
+                   .layout_items_per_page(40)
+                   .layout_frame_rate(0) // every key gets its own frame, measures rendering rather than the cap
+                   .add_section(packages.build())
+                   .terminal_backend(backend)
+                   .render_stats(true)
+                   .build();
+
+    const auto start = std::chrono::steady_clock::now();
+    tui->run();
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    const auto frames = static_cast<double>(backend->total_writes());
+    fmt::println("{} items, {} scripted events, {} colors", item_count, key_count + key_count / 10 + 2,
+                 colors == 24 ? "24-bit" : std::to_string(colors));
+    fmt::println("  frames        {:>10.0f}", frames);
+    fmt::println("  bytes         {:>10}", backend->total_bytes());
+    fmt::println("  bytes/frame   {:>10.1f}", static_cast<double>(backend->total_bytes()) / frames);
+    fmt::println("  time          {:>10.1f} ms", elapsed.count());
+    fmt::println("  frames/s      {:>10.0f}", frames / (elapsed.count() / 1000.0));
+
+    const RenderStats stats = tui->get_render_stats();
+    fmt::println("last {} frames ({} full, {} skipped overall)", std::min<uint64_t>(stats.frames, 1024),
+                 stats.full_frames, stats.skipped_frames);
+    fmt::println("  {:<14} {:>9} {:>9} {:>9}", "phase (us)", "p50", "p99", "max");
+    const auto row = [](const char* name, const RenderStats::Distribution& distribution) {
+        const auto us = [](const std::chrono::nanoseconds ns) { return static_cast<double>(ns.count()) / 1000.0; };
+        fmt::println("  {:<14} {:>9.1f} {:>9.1f} {:>9.1f}", name, us(distribution.p50), us(distribution.p99),
+                     us(distribution.max));
+    };
+    row("frame", stats.frame_time);
+    row("layout", stats.layout);
+    row("format", stats.format);
+    row("emit", stats.emit);
+    row("flush", stats.flush);
+    row("input latency", stats.input_latency);
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <core/unicode.hpp>
+#include <fmt/format.h>
+#include <string>
+#include <vector>
+
+using namespace tui;
+
+// Menu rows and descriptions shaped like a large package list: highlight/selection
+// prefixes, colored counters and 100+ byte UTF-8 descriptions.
+std::vector<std::string> build_menu(const size_t item_count) {
+    std::vector<std::string> strings;
+    strings.reserve(item_count * 2);
+
+    for (size_t i = 0; i < item_count; ++i) {
+        strings.push_back(fmt::format("{}{} package-{:05} \033[90m({}/{})\033[0m", i % 7 == 0 ? "> " : "  ",
+                                      i % 3 == 0 ? "✓" : "○", i, i % 11, 10));
+        strings.push_back(fmt::format("Package number {} — rebuilt from source with LTO, PGO and \033[36mnative\033[0m "
+                                      "tuning; depends on libfoo ≥ 1.{}, libbar and größere Bibliotheken{}",
+                                      i, i % 20, i % 5 == 0 ? " (日本語パッケージ 🚀)" : ""));
+    }
+    return strings;
+}
+
+template <typename Function>
+double measure(const std::vector<std::string>& strings, const int rounds, Function&& function, size_t& checksum) {
+    checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const auto& string : strings) {
+            checksum += function(string);
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(rounds);
+}
+
+int main() {
+    constexpr size_t item_count = 10000;
+    constexpr int rounds = 50;
+
+    const auto strings = build_menu(item_count);
+
+    size_t total_bytes = 0;
+    for (const auto& string : strings) {
+        total_bytes += string.size();
+    }
+
+    const auto throughput = [total_bytes](const double ns) { return static_cast<double>(total_bytes) / ns; };
+    fmt::println("{} strings, {} bytes per pass ({} rounds)", strings.size(), total_bytes, rounds);
+
+    const auto compare = [&](const char* title, auto&& scalar, auto&& kernel) {
+        size_t scalar_sum = 0;
+        size_t kernel_sum = 0;
+        const double scalar_ns = measure(strings, rounds, scalar, scalar_sum);
+        const double kernel_ns = measure(strings, rounds, kernel, kernel_sum);
+
+        fmt::println("{}", title);
+        fmt::println("  scalar  {:>10.0f} ns/pass  {:>6.2f} GB/s", scalar_ns, throughput(scalar_ns));
+        fmt::println("  {:<7} {:>10.0f} ns/pass  {:>6.2f} GB/s  ({:.1f}x)", unicode::visible_length_kernel(),
+                     kernel_ns, throughput(kernel_ns), scalar_ns / kernel_ns);
+
+        if (scalar_sum != kernel_sum) {
+            fmt::println("  Mismatch: scalar counted {}, {} counted {}", scalar_sum, unicode::visible_length_kernel(),
+                         kernel_sum);
+            return false;
+        }
+        return true;
+    };
+
+    const bool lengths_match =
+        compare("Code points (visible_length)", unicode::visible_length_scalar, unicode::visible_length);
+    const bool widths_match =
+        compare("Columns (display_width)", unicode::display_width_scalar, unicode::display_width);
+
+    return lengths_match && widths_match ? 0 : 1;
+}
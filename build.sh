@@ -28,6 +28,7 @@ BUILD_DIR="$PROJECT_DIR/build"
 BUILD_TYPE="Release"
 CLEAN_BUILD=false
 BUILD_EXAMPLES=true
+BUILD_BENCHMARKS=false
 BUILD_LIBRARY=true
 BUILD_INSTALL=false
 BUILD_EXECUTABLE=false
@@ -50,6 +51,10 @@ while [[ $# -gt 0 ]]; do
             BUILD_EXAMPLES=false
             shift
             ;;
+        -b|--benchmarks)
+            BUILD_BENCHMARKS=true
+            shift
+            ;;
         -bi|--build-install)
             BUILD_INSTALL=true
             shift
@@ -93,6 +98,7 @@ while [[ $# -gt 0 ]]; do
             echo "Component Options:"
             echo "  -e, --examples      Build examples (default: ON)"
             echo "  --no-examples       Don't build examples"
+            echo "  -b, --benchmarks    Build benchmarks (default: OFF)"
             echo "  -l, --library       Build static library (default: ON)"
             echo "  --no-library        Don't build static library"
             echo "  --executable        Build main executable (default: OFF)"
@@ -126,6 +132,7 @@ echo "   Build Type: $BUILD_TYPE"
 echo "   Clean Build: $CLEAN_BUILD"
 echo "   Build Library: $BUILD_LIBRARY"
 echo "   Build Examples: $BUILD_EXAMPLES"
+echo "   Build Benchmarks: $BUILD_BENCHMARKS"
 echo "   Build Executable: $BUILD_EXECUTABLE"
 echo "   Build Install: $BUILD_INSTALL"
 echo ""
@@ -147,6 +154,12 @@ else
     CMAKE_OPTIONS="$CMAKE_OPTIONS -DBUILD_EXAMPLES=OFF"
 fi
 
+if [ "$BUILD_BENCHMARKS" = true ]; then
+    CMAKE_OPTIONS="$CMAKE_OPTIONS -DBUILD_BENCHMARKS=ON"
+else
+    CMAKE_OPTIONS="$CMAKE_OPTIONS -DBUILD_BENCHMARKS=OFF"
+fi
+
 if [ "$BUILD_LIBRARY" = true ]; then
     CMAKE_OPTIONS="$CMAKE_OPTIONS -DBUILD_LIBRARY=ON"
 else
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include "core/input.hpp"
+#include "core/style.hpp"
+
+namespace tui {
+
+    /**
+     * @brief Why TerminalBackend::wait() returned, nothing set after a timeout
+     */
+    struct WaitResult {
+        bool input = false;       ///< Key input is ready
+        bool resized = false;     ///< The terminal size changed
+        bool woken = false;       ///< wake() was called
+        int terminate_signal = 0; ///< SIGTERM or SIGINT that arrived, 0 if none
+
+        [[nodiscard]] bool any() const { return input || resized || woken || terminate_signal != 0; }
+    };
+
+    /**
+     * @brief Where terminal output goes, where key events come from and how big the screen is
+     *
+     * TerminalUtils queues escape sequences in its OutputBuffer and hands each frame
+     * to the active backend, TerminalManager reads keys and the terminal size through
+     * it. ConsoleBackend talks to the real terminal, HeadlessBackend keeps everything
+     * in memory.
+     */
+    class TerminalBackend {
+    public:
+        virtual ~TerminalBackend() = default;
+
+        /**
+         * @brief Prepare the device for full-screen use (raw input, console modes)
+         */
+        virtual void init() {}
+
+        /**
+         * @brief Undo init()
+         */
+        virtual void restore() {}
+
+        /**
+         * @brief Write one chunk of output
+         * @return number of bytes written
+         */
+        virtual size_t write(std::string_view bytes) = 0;
+
+        /**
+         * @brief Next pending key event, std::nullopt if none is available right now
+         */
+        virtual std::optional<KeyEvent> read_key() = 0;
+
+        /**
+         * @brief Block until input is available or the timeout expires
+         * @return true if input is available
+         */
+        virtual bool wait_for_input(int timeout_ms) = 0;
+
+        /**
+         * @brief Block until input, a resize, a termination signal or wake(), or until the timeout expires
+         *
+         * The default only waits for input, see event_driven().
+         */
+        virtual WaitResult wait(const int timeout_ms) {
+            WaitResult result;
+            result.input = wait_for_input(timeout_ms);
+            return result;
+        }
+
+        /**
+         * @brief Interrupt a wait() in progress, may be called from any thread
+         */
+        virtual void wake() {}
+
+        /**
+         * @brief Whether wait() reports resizes and wake() interrupts it
+         *
+         * Only then may the caller sleep without a timeout, otherwise it has to poll the size now and then.
+         */
+        virtual bool event_driven() { return false; }
+
+        /**
+         * @brief How long a lone ESC waits for the rest of an escape sequence before it is the Escape key
+         *
+         * Backends that receive whole key events ignore it.
+         */
+        virtual void set_escape_timeout(int /*timeout_ms*/) {}
+
+        /**
+         * @brief Current size as (rows, columns)
+         */
+        virtual std::pair<int, int> query_size() = 0;
+
+        /**
+         * @brief Whether frames may be bracketed with DEC mode 2026, asked once by init_terminal()
+         */
+        virtual bool supports_synchronized_output() { return false; }
+
+        /**
+         * @brief Colors the device can display, asked once by init_terminal()
+         */
+        virtual ColorDepth color_depth() { return ColorDepth::TRUECOLOR; }
+    };
+
+} // namespace tui
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/backend.hpp"
+
+#ifdef __linux__
+#include <array>
+#include <csignal>
+#endif
+
+namespace tui {
+
+    /**
+     * @brief Sleeps on terminal input, resize and termination signals and cross-thread wakeups at once
+     *
+     * One epoll instance watches the input descriptor, a self-pipe for SIGWINCH,
+     * SIGTERM and SIGINT and an eventfd that wake() writes to, so an idle program
+     * stays asleep until one of them fires. open() installs handlers for the
+     * signals that write the signal number to the pipe, so they reach the loop
+     * whichever thread the kernel delivers them to, and close() puts the previous
+     * handlers back. A SIGTERM or SIGINT that arrived meanwhile is reported by
+     * wait() for the caller to act on.
+     *
+     * Signal handlers are process-wide, so only one loop can be open at a time.
+     * Linux only, open() fails elsewhere and the console backend keeps using select().
+     */
+    class EventLoop {
+    public:
+        EventLoop() = default;
+        ~EventLoop() { close(); }
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+
+        /**
+         * @return false if the platform or the kernel does not provide the descriptors
+         */
+        bool open(int input_fd);
+        void close();
+        [[nodiscard]] bool is_open() const { return epoll_fd_ >= 0; }
+
+        /**
+         * @brief Block until something happens or the timeout expires, -1 waits without a timeout
+         */
+        WaitResult wait(int timeout_ms);
+
+        /**
+         * @brief Interrupt wait(), safe to call from any thread while the loop is open
+         */
+        void wake() const;
+
+    private:
+        int epoll_fd_ = -1;
+        int input_fd_ = -1;
+        int signal_fd_ = -1;       ///< Read end of the self-pipe the signal handler writes to
+        int signal_write_fd_ = -1;
+        int wake_fd_ = -1;
+#ifdef __linux__
+        bool handlers_installed_ = false;
+        std::array<struct sigaction, 3> previous_actions_{}; ///< Handlers of SIGWINCH, SIGTERM, SIGINT before open()
+#endif
+    };
+
+} // namespace tui
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+namespace tui {
+
+    /**
+     * @brief Decides when the next frame is drawn
+     *
+     * Invalidations are only requests, any number of them between two frames
+     * makes a single frame. Frames are at least one interval apart. Input-driven
+     * requests are served at the next free slot, timer-driven ones (update
+     * callbacks) wait a whole interval after they first came in, so input never
+     * queues behind them. Without requests there are no frames at all.
+     */
+    class FrameScheduler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        enum class Source {
+            INPUT, ///< Keys, resizes
+            TIMER  ///< Update callbacks and other background changes
+        };
+
+        /**
+         * @brief Cap the frame rate, 0 draws every request right away
+         */
+        void set_frame_rate(int frames_per_second);
+
+        void request(Source source, Clock::time_point now);
+
+        [[nodiscard]] bool pending() const { return input_since_.has_value() || timer_since_.has_value(); }
+
+        /**
+         * @brief Earliest time the pending frame may be drawn, only meaningful while pending()
+         */
+        [[nodiscard]] Clock::time_point deadline() const;
+
+        [[nodiscard]] bool due(const Clock::time_point now) const { return pending() && now >= deadline(); }
+
+        /**
+         * @brief Milliseconds until the pending frame is due (rounded up), -1 when nothing is pending
+         */
+        [[nodiscard]] int milliseconds_until_due(Clock::time_point now) const;
+
+        /**
+         * @brief A frame was drawn, every request so far is served
+         */
+        void frame_drawn(Clock::time_point now);
+
+    private:
+        Clock::duration interval_{};
+        std::optional<Clock::time_point> last_frame_;
+        std::optional<Clock::time_point> input_since_; ///< Oldest unserved input request
+        std::optional<Clock::time_point> timer_since_; ///< Oldest unserved timer request
+    };
+
+} // namespace tui
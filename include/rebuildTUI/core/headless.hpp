@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/backend.hpp"
+#include "core/screen.hpp"
+
+namespace tui {
+
+    /**
+     * @brief In-memory terminal for benchmarks and tests without a TTY
+     *
+     * Records every byte the library writes and interprets it on a virtual
+     * screen (cursor movement, erase, scroll regions, SGR, alternate screen),
+     * so the visible result of a frame can be inspected cell by cell. Input
+     * comes from a script of key events and resizes.
+     *
+     * Each wait() releases one scripted event, the way keys typed by a person
+     * arrive one loop iteration at a time, and reports scripted resizes. Once the
+     * script is used up wait() returns nothing right away, so scripts normally end with 'q'.
+     */
+    class HeadlessBackend final : public TerminalBackend {
+    public:
+        explicit HeadlessBackend(int rows = 24, int cols = 80);
+
+        size_t write(std::string_view bytes) override;
+        std::optional<KeyEvent> read_key() override;
+        bool wait_for_input(int timeout_ms) override;
+        WaitResult wait(int timeout_ms) override;
+        bool event_driven() override { return true; }
+        std::pair<int, int> query_size() override { return {rows_, cols_}; }
+        bool supports_synchronized_output() override { return synchronized_output_; }
+        ColorDepth color_depth() override { return color_depth_; }
+
+        /**
+         * @brief Scripted input
+         *
+         * push_keys() maps each byte like a plain keypress ('\n' is Enter, ' ' is Space),
+         * push_resize() changes the size once the script reaches it.
+         */
+        void push_key(Key key, char character = '\0');
+        void push_keys(std::string_view characters);
+        void push_resize(int rows, int cols);
+        [[nodiscard]] size_t pending_events() const { return events_.size(); }
+
+        /**
+         * @brief Resize right away, the virtual screen keeps its top-left contents
+         */
+        void resize(int rows, int cols);
+
+        /**
+         * @brief Whether init_terminal() should enable DEC 2026 frames, off by default
+         */
+        void set_synchronized_output(const bool enable) { synchronized_output_ = enable; }
+
+        /**
+         * @brief Color depth reported to init_terminal(), truecolor by default
+         */
+        void set_color_depth(const ColorDepth depth) { color_depth_ = depth; }
+
+        /**
+         * @brief Recorded output
+         *
+         * With recording off the bytes still reach the virtual screen and the
+         * counters, but are not kept, which keeps long benchmark runs small.
+         */
+        void set_recording(const bool enable) { recording_ = enable; }
+        [[nodiscard]] const std::string& output() const { return output_; }
+        void clear_output() { output_.clear(); }
+        [[nodiscard]] uint64_t total_bytes() const { return total_bytes_; }
+        [[nodiscard]] uint64_t total_writes() const { return total_writes_; }
+
+        /**
+         * @brief Virtual screen, rows and columns are 1-based
+         */
+        [[nodiscard]] int rows() const { return rows_; }
+        [[nodiscard]] int cols() const { return cols_; }
+        [[nodiscard]] const Cell& at(int row, int col) const;
+
+        /**
+         * @brief Text of one row without trailing blanks
+         */
+        [[nodiscard]] std::string line(int row) const;
+
+        /**
+         * @brief All rows joined with newlines
+         */
+        [[nodiscard]] std::string screen_text() const;
+
+        [[nodiscard]] int cursor_row() const { return row_; }
+        [[nodiscard]] int cursor_col() const { return col_; }
+        [[nodiscard]] bool cursor_visible() const { return cursor_visible_; }
+
+    private:
+        struct Event {
+            KeyEvent key;
+            int rows = 0; ///< > 0 for a resize
+            int cols = 0;
+        };
+
+        [[nodiscard]] size_t index(const int row, const int col) const {
+            return static_cast<size_t>(row - 1) * static_cast<size_t>(cols_) + static_cast<size_t>(col - 1);
+        }
+
+        /**
+         * @brief Interpret bytes, an incomplete sequence at the end waits for the next write
+         */
+        void feed(std::string_view bytes);
+        void handle_csi(std::string_view parameters, char final);
+        void handle_private_mode(std::string_view parameters, bool enable);
+        void put_glyph(std::string_view glyph, int width);
+        void line_feed();
+        void scroll_region(int lines);
+        void erase(int from_row, int from_col, int to_row, int to_col);
+        void move_to(int row, int col);
+        [[nodiscard]] Cell blank() const;
+
+        int rows_;
+        int cols_;
+        std::vector<Cell> grid_;
+        std::vector<Cell> primary_; ///< Main screen contents while the alternate screen is active
+        bool alternate_screen_ = false;
+
+        // Terminal state
+        int row_ = 1;
+        int col_ = 1;
+        bool pending_wrap_ = false; ///< Last column written, the next glyph wraps first
+        int saved_row_ = 1;
+        int saved_col_ = 1;
+        int scroll_top_ = 1;
+        int scroll_bottom_ = 0; ///< 0 for the last row
+        CellStyle style_;
+        bool cursor_visible_ = true;
+        std::string pending_; ///< Incomplete escape or UTF-8 sequence from the previous write
+
+        // Recording
+        bool recording_ = true;
+        bool synchronized_output_ = false;
+        ColorDepth color_depth_ = ColorDepth::TRUECOLOR;
+        std::string output_;
+        uint64_t total_bytes_ = 0;
+        uint64_t total_writes_ = 0;
+
+        // Script
+        std::deque<Event> events_;
+        bool released_ = false; ///< wait_for_input() handed out the front key
+    };
+
+} // namespace tui
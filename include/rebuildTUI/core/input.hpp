@@ -1,5 +1,12 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string_view>
 #include <utility>
 
 namespace tui {
@@ -39,28 +46,170 @@ namespace tui {
         F9 = 28,
         F10 = 29,
         F11 = 30,
-        F12 = 31
+        F12 = 31,
+        INSERT = 32
     };
 
+    /**
+     * @brief Modifier bits of a KeyEvent
+     */
+    enum class KeyModifier : uint8_t { NONE = 0, SHIFT = 1, ALT = 2, CTRL = 4 };
+
     /**
      * @brief Key event structure
      */
     struct KeyEvent {
         Key key;
         char character;
+        uint8_t modifiers; ///< KeyModifier bits, from modified escape sequences and Alt (ESC prefix)
+
+        explicit KeyEvent(const Key k = Key::UNKNOWN, const char c = '\0', const uint8_t m = 0) :
+            key(k), character(c), modifiers(m) {}
 
-        explicit KeyEvent(const Key k = Key::UNKNOWN, const char c = '\0') : key(k), character(c) {}
+        [[nodiscard]] bool has(const KeyModifier modifier) const {
+            return (modifiers & static_cast<uint8_t>(modifier)) != 0;
+        }
+    };
+
+    /**
+     * @brief Fixed-size ring of input bytes that are read but not parsed yet
+     *
+     * Input fills it with one large read per burst (pasted text, key repeat)
+     * instead of one read per byte, the key parser consumes from the front.
+     */
+    class InputBuffer {
+    public:
+        static constexpr size_t CAPACITY = 4096;
+
+        [[nodiscard]] bool empty() const { return size_ == 0; }
+        [[nodiscard]] size_t size() const { return size_; }
+
+        /**
+         * @brief Byte at offset from the front, EOF past the end
+         */
+        [[nodiscard]] int peek(const size_t offset = 0) const {
+            return offset < size_ ? static_cast<unsigned char>(data_[(head_ + offset) % CAPACITY]) : EOF;
+        }
+
+        void consume(const size_t count) {
+            const size_t n = count < size_ ? count : size_;
+            head_ = (head_ + n) % CAPACITY;
+            size_ -= n;
+            if (size_ == 0) {
+                head_ = 0; // The next read gets the whole buffer as one span
+            }
+        }
+
+        int pop() {
+            const int byte = peek();
+            consume(1);
+            return byte;
+        }
+
+        /**
+         * @brief Free space right after the last byte, to read() into before commit()
+         */
+        [[nodiscard]] std::pair<char*, size_t> write_span() {
+            const size_t tail = (head_ + size_) % CAPACITY;
+            const size_t end = (tail < head_ || size_ == CAPACITY) ? head_ : CAPACITY;
+            return {data_.data() + tail, end - tail};
+        }
+
+        void commit(const size_t count) { size_ += count; }
+
+        void push(const char byte) {
+            if (size_ < CAPACITY) {
+                data_[(head_ + size_) % CAPACITY] = byte;
+                ++size_;
+            }
+        }
+
+        void clear() { head_ = size_ = 0; }
+
+    private:
+        std::array<char, CAPACITY> data_{};
+        size_t head_ = 0;
+        size_t size_ = 0;
     };
 
     class Input {
     public:
+        /**
+         * @brief Next input byte, reads more into the buffer and waits for it when the buffer is empty
+         */
         static int get_key();
+
+        /**
+         * @brief Whether a byte is buffered, reads whatever arrived when the buffer is empty
+         */
         static bool key_available();
         static std::pair<Key, char> get_input();
+
+        /**
+         * @brief Next complete key if one is buffered or ready, std::nullopt otherwise
+         *
+         * Never blocks. A lone ESC or a sequence cut short stays buffered until its
+         * rest arrives or the escape timeout runs out, then the ESC counts as a key.
+         */
+        static std::optional<KeyEvent> read_event();
+
+        /**
+         * @brief Wait until input is buffered or arrives, -1 waits without a timeout
+         *
+         * While half a sequence is buffered this also wakes up when the escape timeout runs out.
+         */
         static bool wait_for_input(int timeout_ms);
 
+        /**
+         * @brief Milliseconds until read_event() has a key without new input
+         *
+         * 0 for a complete key in the buffer, the time left on the escape timeout for half
+         * a sequence, -1 for an empty buffer. For callers that wait on stdin themselves.
+         */
+        static int milliseconds_until_ready();
+
+        /**
+         * @brief How long a lone ESC waits for the rest of a sequence, 25 ms by default
+         */
+        static void set_escape_timeout(int timeout_ms);
+
+        /**
+         * @brief Drop buffered bytes, e.g. when the terminal is restored
+         */
+        static void discard_pending() {
+            buffer_.clear();
+            escape_since_.reset();
+        }
+
+        /**
+         * @brief Queue bytes read from the terminal elsewhere, e.g. keys typed during a terminal query
+         */
+        static void push_pending(const std::string_view bytes) {
+            for (const char byte : bytes) {
+                buffer_.push(byte);
+            }
+        }
+
+        /**
+         * @brief Key for a single input byte that starts no escape sequence
+         */
+        static std::pair<Key, char> map_character(int ch);
+
     private:
-        static Key parse_escape_sequence();
+        /**
+         * @brief Move everything the terminal has ready into the buffer without blocking
+         * @return true if bytes were added
+         */
+        static bool fill_buffer();
+
+        /**
+         * @brief Wait for the terminal itself, ignoring what is buffered
+         */
+        static bool poll_input(int timeout_ms);
+
+        static InputBuffer buffer_;
+        static std::chrono::milliseconds escape_timeout_;
+        static std::optional<std::chrono::steady_clock::time_point> escape_since_; ///< Half a sequence is buffered
     };
 
 } // namespace tui
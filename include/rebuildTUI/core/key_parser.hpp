@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include "core/input.hpp"
+
+namespace tui {
+
+    /**
+     * @brief One key decoded from the front of the input buffer
+     */
+    struct ParsedKey {
+        enum class Status {
+            KEY,       ///< event is complete, length bytes belong to it
+            INCOMPLETE ///< The bytes start a sequence whose rest has not arrived yet
+        };
+
+        Status status = Status::KEY;
+        KeyEvent event;
+        size_t length = 0;
+    };
+
+    /**
+     * @brief Decode one key from the front of the buffer in a single pass
+     *
+     * Handles the xterm CSI and SS3 forms (cursor keys, Home/End, Insert/Delete,
+     * Page Up/Down, F1-F12) with their modifier parameter, the Linux console
+     * "ESC [ [ A" form of F1-F5, the kitty "CSI codepoint ; modifiers u" encoding,
+     * Alt+key sent as ESC followed by the key, and single bytes. Well-formed sequences without a meaning decode to
+     * Key::UNKNOWN and are skipped as a whole.
+     *
+     * A lone ESC or a sequence cut short is INCOMPLETE, only the caller knows
+     * whether more bytes are coming. Once it gives up waiting, flush = true
+     * decodes the ESC on its own and leaves the rest for the next call.
+     */
+    ParsedKey parse_key(const InputBuffer& buffer, bool flush = false);
+
+} // namespace tui
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fmt/format.h>
+#include <string>
+#include <string_view>
+
+namespace tui {
+
+    class TerminalBackend;
+
+    /**
+     * @brief Growable byte buffer that collects terminal output for one frame
+     *
+     * Every TerminalUtils primitive appends to the buffer instead of writing
+     * to stdout, flush() then hands the whole frame to the terminal backend
+     * with a single write call.
+     */
+    class OutputBuffer {
+    public:
+        OutputBuffer() { buffer_.reserve(4096); }
+
+        void append(const std::string_view bytes) { buffer_.append(bytes.data(), bytes.size()); }
+        void append(const char c) { buffer_.push_back(c); }
+
+        template <typename... Args>
+        void format(fmt::format_string<Args...> format_str, Args&&... args) {
+            fmt::format_to(std::back_inserter(buffer_), format_str, std::forward<Args>(args)...);
+        }
+
+        [[nodiscard]] bool empty() const { return buffer_.empty(); }
+        [[nodiscard]] size_t size() const { return buffer_.size(); }
+        [[nodiscard]] std::string_view view() const { return buffer_; }
+
+        /**
+         * @brief Drop pending bytes without writing them
+         */
+        void discard() { buffer_.clear(); }
+
+        /**
+         * @brief Write all pending bytes to the backend
+         * @return number of bytes written
+         */
+        size_t flush(TerminalBackend& backend);
+
+        [[nodiscard]] uint64_t total_bytes() const { return total_bytes_; }
+        [[nodiscard]] uint64_t total_writes() const { return total_writes_; }
+
+    private:
+        std::string buffer_;
+        uint64_t total_bytes_ = 0;
+        uint64_t total_writes_ = 0;
+    };
+
+} // namespace tui
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace tui {
+
+    /**
+     * @brief Cost of a single frame
+     *
+     * Phases: layout (geometry), format (building rows and drawing them into the
+     * cell grid), emit (diffing the grid into escape sequences) and flush (handing
+     * the bytes to the terminal).
+     */
+    struct FrameStats {
+        uint64_t frame = 0; ///< 1-based frame number
+        bool full_frame = false; ///< false for a partial (dirty rows) redraw
+        std::chrono::nanoseconds total{0};
+        std::chrono::nanoseconds layout{0};
+        std::chrono::nanoseconds format{0};
+        std::chrono::nanoseconds emit{0};
+        std::chrono::nanoseconds flush{0};
+        size_t bytes = 0;  ///< Bytes written for the frame
+        size_t writes = 0; ///< Write calls for the frame
+        std::optional<std::chrono::nanoseconds> input_latency; ///< First key since the last frame until flushed
+    };
+
+    /**
+     * @brief Aggregated frame statistics
+     *
+     * Counters cover the whole run, percentiles and averages the last RenderStatsCollector::WINDOW frames.
+     */
+    struct RenderStats {
+        struct Distribution {
+            std::chrono::nanoseconds p50{0};
+            std::chrono::nanoseconds p99{0};
+            std::chrono::nanoseconds max{0};
+        };
+
+        uint64_t frames = 0;
+        uint64_t skipped_frames = 0; ///< Render passes that found nothing to draw
+        uint64_t full_frames = 0;
+        uint64_t total_bytes = 0;
+        uint64_t total_writes = 0;
+
+        Distribution frame_time;
+        Distribution layout;
+        Distribution format;
+        Distribution emit;
+        Distribution flush;
+        Distribution input_latency; ///< Only frames that answered input
+
+        double bytes_per_frame = 0;
+        double writes_per_frame = 0;
+    };
+
+    /**
+     * @brief Keeps the recent FrameStats and turns them into RenderStats on request
+     */
+    class RenderStatsCollector {
+    public:
+        static constexpr size_t WINDOW = 1024;
+
+        /**
+         * @brief Add a finished frame, assigns its frame number
+         */
+        void record(FrameStats& frame);
+        void record_skipped() { ++skipped_frames_; }
+
+        [[nodiscard]] RenderStats snapshot() const;
+        void reset();
+
+    private:
+        std::vector<FrameStats> window_; ///< Ring buffer of the last WINDOW frames
+        size_t next_ = 0;
+        uint64_t frames_ = 0;
+        uint64_t skipped_frames_ = 0;
+        uint64_t full_frames_ = 0;
+        uint64_t total_bytes_ = 0;
+        uint64_t total_writes_ = 0;
+    };
+
+    /**
+     * @brief Adds the time until it goes out of scope to a phase, does nothing when inactive
+     */
+    class ScopedPhase {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        ScopedPhase(const bool active, std::chrono::nanoseconds& phase) :
+            phase_(active ? &phase : nullptr), start_(active ? Clock::now() : Clock::time_point{}) {}
+        ~ScopedPhase() {
+            if (phase_) {
+                *phase_ += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_);
+            }
+        }
+
+        ScopedPhase(const ScopedPhase&) = delete;
+        ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    private:
+        std::chrono::nanoseconds* phase_;
+        Clock::time_point start_;
+    };
+
+} // namespace tui
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/style.hpp"
+
+namespace tui {
+
+    /**
+     * @brief A single character cell: one glyph plus its display attributes
+     *
+     * A wide (two column) glyph lives in the left cell, the right cell keeps an
+     * empty glyph. Zero-width code points are stored with the glyph they follow.
+     */
+    struct Cell {
+        std::string glyph = " "; ///< UTF-8 encoded glyph, empty for the right half of a wide glyph
+        CellStyle style;
+
+        bool operator==(const Cell& other) const { return glyph == other.glyph && style == other.style; }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Double-buffered cell grid
+     *
+     * Rendering code draws the next frame into the back buffer, flush() then
+     * compares it against the front buffer (what the terminal currently shows)
+     * and emits only the cells that changed.
+     * Rows and columns are 1-based, like TerminalUtils::move_cursor.
+     */
+    class ScreenBuffer {
+    public:
+        ScreenBuffer() = default;
+
+        /**
+         * @brief Resize both buffers, forces a full repaint on the next flush if the size changed
+         */
+        void resize(int rows, int cols);
+
+        [[nodiscard]] int rows() const { return rows_; }
+        [[nodiscard]] int cols() const { return cols_; }
+
+        /**
+         * @brief Reset the back buffer to blank cells
+         */
+        void clear();
+
+        /**
+         * @brief Reset a single row of the back buffer to blank cells
+         */
+        void clear_line(int row);
+
+        /**
+         * @brief Forget what the terminal shows, the next flush clears the screen and repaints everything
+         */
+        void invalidate() { front_valid_ = false; }
+
+        /**
+         * @brief Draw text into the back buffer
+         *
+         * SGR sequences embedded in the text update the style of the following cells,
+         * other escape sequences and control characters are dropped. Wide glyphs take
+         * two cells, combining marks join the previous cell. Text is clipped at the
+         * right edge of the screen.
+         *
+         * @return column right after the last drawn cell
+         */
+        int draw_text(int row, int col, std::string_view text, const CellStyle& style = {});
+
+        [[nodiscard]] const Cell& at(int row, int col) const;
+
+        /**
+         * @brief Scroll rows top..bottom of the terminal by the given number of lines
+         *
+         * Sets a DECSTBM scroll region and emits SU (positive lines, contents move up)
+         * or SD (negative lines), then shifts the front buffer the same way so the next
+         * flush only repaints the rows that scrolled into view. Does nothing while the
+         * front buffer is invalid or when no row would survive the scroll.
+         */
+        void scroll(int top, int bottom, int lines);
+
+        /**
+         * @brief Queue the difference between the back and the front buffer
+         *
+         * The bytes go to TerminalUtils::output(), the caller decides when to write them.
+         */
+        void flush();
+
+    private:
+        [[nodiscard]] size_t index(int row, int col) const {
+            return static_cast<size_t>(row - 1) * static_cast<size_t>(cols_) + static_cast<size_t>(col - 1);
+        }
+
+        /**
+         * @brief Store a glyph of the given width, blanking any wide glyph it cuts in half
+         */
+        void put(int row, int col, std::string_view glyph, const CellStyle& style, int width);
+
+        int rows_ = 0;
+        int cols_ = 0;
+        bool front_valid_ = false;
+        std::vector<Cell> back_;
+        std::vector<Cell> front_;
+    };
+
+} // namespace tui
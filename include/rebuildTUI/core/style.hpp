@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include "core/output.hpp"
+#include "theme/colors.hpp"
+
+namespace tui {
+
+    /**
+     * @brief Foreground or background color of a screen cell
+     */
+    struct CellColor {
+        enum class Type : uint8_t {
+            DEFAULT, ///< Terminal default color
+            ANSI,    ///< Classic SGR color code (30-37, 90-97 or their background variants)
+            INDEXED, ///< 256-color palette index
+            RGB      ///< 24-bit color
+        };
+
+        Type type = Type::DEFAULT;
+        uint8_t code = 0; ///< SGR code for ANSI colors, palette index for INDEXED colors
+        uint8_t r = 0, g = 0, b = 0;
+
+        bool operator==(const CellColor& other) const {
+            return type == other.type && code == other.code && r == other.r && g == other.g && b == other.b;
+        }
+        bool operator!=(const CellColor& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Display attributes of a single screen cell
+     */
+    struct CellStyle {
+        enum Attribute : uint8_t {
+            NONE = 0,
+            BOLD = 1 << 0,
+            DIM = 1 << 1,
+            ITALIC = 1 << 2,
+            UNDERLINE = 1 << 3,
+            BLINK = 1 << 4,
+            REVERSE = 1 << 5,
+            STRIKETHROUGH = 1 << 6
+        };
+
+        CellColor fg;
+        CellColor bg;
+        uint8_t attributes = NONE;
+
+        /**
+         * @brief Build a foreground-only style from a palette color
+         */
+        static CellStyle from_color(const extras::Color& color);
+        static CellStyle from_rgb(uint8_t r, uint8_t g, uint8_t b);
+
+        bool operator==(const CellStyle& other) const {
+            return fg == other.fg && bg == other.bg && attributes == other.attributes;
+        }
+        bool operator!=(const CellStyle& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Colors a terminal can display
+     */
+    enum class ColorDepth : uint8_t {
+        ANSI16,     ///< The 16 classic colors (SGR 30-37, 90-97)
+        INDEXED256, ///< xterm 256-color palette (SGR 38;5;n)
+        TRUECOLOR   ///< 24-bit RGB (SGR 38;2;r;g;b)
+    };
+
+    /**
+     * @brief Reduce a color to one the given depth can display
+     *
+     * RGB colors are looked up in tables built once for all colors at 5 bits per
+     * channel, 256-color indices above 15 go through their palette RGB value.
+     * ANSI colors pass through unchanged.
+     *
+     * @param background produce background codes (40-47, 100-107) for ANSI results
+     */
+    [[nodiscard]] CellColor downsample(const CellColor& color, ColorDepth depth, bool background = false);
+    [[nodiscard]] CellStyle downsample(const CellStyle& style, ColorDepth depth);
+
+    /**
+     * @brief Apply the parameters of an SGR sequence (the part between ESC[ and m) to a style
+     */
+    void apply_sgr(std::string_view parameters, CellStyle& style);
+
+    /**
+     * @brief Tracks the SGR state of the terminal and emits only what changes
+     *
+     * Attributes that go away are switched off with their own reset codes
+     * (22, 23, ...) unless a full reset followed by the new style is shorter.
+     * All parameters of a transition go out as a single ESC[...m sequence.
+     */
+    class SgrState {
+    public:
+        /**
+         * @brief Queue the shortest SGR sequence that turns the current style into the given one
+         */
+        void transition(OutputBuffer& out, const CellStyle& style);
+
+        /**
+         * @brief The terminal may have changed its style behind our back, the next transition starts with a reset
+         */
+        void forget() { known_ = false; }
+
+        [[nodiscard]] bool known() const { return known_; }
+        [[nodiscard]] const CellStyle& current() const { return current_; }
+
+    private:
+        CellStyle current_;
+        bool known_ = false;
+    };
+
+} // namespace tui
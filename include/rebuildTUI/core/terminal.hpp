@@ -1,8 +1,13 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <string>
+#include "core/backend.hpp"
+#include "core/event_loop.hpp"
 #include "core/input.hpp"
+#include "core/output.hpp"
+#include "core/style.hpp"
 #include "theme/colors.hpp"
 #include "theme/gradient.hpp"
 // #include <iostream>
@@ -60,15 +65,48 @@ namespace tui {
             STRIKETHROUGH = 9
         };
 
-        static void init_terminal();
+        /**
+         * @brief Switch to raw input and prepare the screen
+         * @param alternate_screen draw on the alternate screen buffer, restore_terminal() leaves it again
+         */
+        static void init_terminal(bool alternate_screen = false);
         static void restore_terminal();
         static void clear_screen();
+
         static void move_cursor(int row, int col);
+
+        /**
+         * @brief Queue the cheapest escape sequence that moves the cursor
+         *
+         * While the cursor position is known, relative moves (CUU/CUD/CUF/CUB,
+         * backspace) and CR/LF are weighed against an absolute CUP.
+         */
+        static void append_cursor_move(int row, int col);
+
+        /**
+         * @brief Cursor tracking for move_cursor()
+         *
+         * advance_cursor() records text of the given width written at the cursor,
+         * forget_cursor_position() makes the next move absolute, e.g. after output
+         * the primitives did not produce.
+         */
+        static void advance_cursor(int columns);
+        static void forget_cursor_position() { cursor_row_ = 0; }
         static void hide_cursor();
         static void show_cursor();
+        /**
+         * @brief Terminal size as (rows, columns), served from a cache
+         *
+         * refresh_terminal_size() asks the terminal again and updates the cache,
+         * init_terminal() and the resize handling of the caller do that.
+         */
         static std::pair<int, int> get_terminal_size();
+        static std::pair<int, int> refresh_terminal_size();
         static void set_color(Color color);
         static void set_color(extras::AccentColor color);
+        /**
+         * @brief Number of terminal columns the string occupies, escape sequences excluded
+         */
         static size_t get_visible_string_length(const std::string& string);
 
         // Gradient
@@ -78,6 +116,18 @@ namespace tui {
         static void set_style(Style style);
         static void reset_formatting();
 
+        /**
+         * @brief Switch to the given style, emitting only the SGR parameters that change
+         *
+         * set_color(), set_style() and reset_formatting() go through the same tracker.
+         */
+        static void apply_style(const CellStyle& style) { sgr_.transition(output_, style); }
+
+        /**
+         * @brief Forget the tracked style, e.g. after output that carried its own SGR sequences
+         */
+        static void forget_style() { sgr_.forget(); }
+
         static void draw_horizontal_line(int row, int start_col, int length, char ch = '-');
         static void draw_vertical_line(int start_row, int col, int length, char ch = '|');
         static void draw_box(int top_row, int left_col, int width, int height);
@@ -94,9 +144,59 @@ namespace tui {
         static void restore_cursor_position();
         static void set_echo(bool enable);
         static void set_canonical_mode(bool enable);
+
+        /**
+         * @brief Bracket a frame with DEC mode 2026 so the terminal presents it atomically
+         *
+         * Both calls are no-ops when init_terminal found no support for synchronized output.
+         */
+        static void begin_synchronized_update();
+        static void end_synchronized_update();
+        static bool supports_synchronized_output() { return synchronized_output_; }
+
+        /**
+         * @brief Colors the terminal can display
+         *
+         * Asked from the backend by init_terminal() (or on first use), RGB colors
+         * passed to set_color_rgb() are reduced to it.
+         */
+        static ColorDepth color_depth();
+
+        /**
+         * @brief Write everything the primitives above have queued since the last flush
+         */
         static void flush();
 
+        /**
+         * @brief Frame output buffer all primitives append to
+         */
+        static OutputBuffer& output() { return output_; }
+
+        /**
+         * @brief Route output, input and size queries through the given backend
+         *
+         * nullptr switches back to the console. The backend must outlive its use,
+         * TerminalManager keeps it alive while the terminal is set up. Cursor and
+         * style tracking as well as the cached size start over.
+         */
+        static void set_backend(TerminalBackend* backend);
+        static TerminalBackend& backend();
+
     private:
+        friend class ConsoleBackend;
+
+        static OutputBuffer output_;
+        static TerminalBackend* backend_; ///< nullptr while the console is used
+        static SgrState sgr_;
+        static bool synchronized_output_;
+        static bool alternate_screen_;
+        static std::optional<ColorDepth> color_depth_; ///< Unset until asked
+
+        // Tracked cursor position, row 0 while unknown
+        static int cursor_row_;
+        static int cursor_col_;
+        static std::pair<int, int> terminal_size_; ///< Cached (rows, columns), rows 0 until first queried
+
 #ifdef _WIN32
         static HANDLE hConsole;
         static CONSOLE_SCREEN_BUFFER_INFO csbi;
@@ -108,6 +208,45 @@ namespace tui {
 #endif
         static void init_platform_terminal();
         static void restore_platform_terminal();
+
+        /**
+         * @brief Set an SGR foreground code (30-37, 90-97) through the style tracker
+         */
+        static void set_foreground(int code);
+
+        /**
+         * @brief Ask the terminal (DECRQM) whether it implements synchronized output
+         */
+        static bool query_synchronized_output();
+    };
+
+    /**
+     * @brief Backend for the real terminal: stdout, stdin and the platform console APIs
+     *
+     * On Windows some TerminalUtils primitives still call the console API directly.
+     */
+    class ConsoleBackend final : public TerminalBackend {
+    public:
+        void init() override;
+        void restore() override;
+        size_t write(std::string_view bytes) override;
+        std::optional<KeyEvent> read_key() override;
+        bool wait_for_input(int timeout_ms) override;
+        WaitResult wait(int timeout_ms) override;
+        void wake() override { events_.wake(); }
+        bool event_driven() override { return events_.is_open(); }
+        void set_escape_timeout(const int timeout_ms) override { Input::set_escape_timeout(timeout_ms); }
+        std::pair<int, int> query_size() override;
+        bool supports_synchronized_output() override { return synchronized_output_; }
+
+        /**
+         * @brief Color depth from COLORTERM, TERM and the terminfo entry for TERM
+         */
+        ColorDepth color_depth() override;
+
+    private:
+        bool synchronized_output_ = false; ///< DECRQM answer from init()
+        EventLoop events_;                 ///< Open between init() and restore() where supported
     };
 
     /**
@@ -115,19 +254,22 @@ namespace tui {
      */
     class TerminalManager {
     private:
+        std::shared_ptr<TerminalBackend> backend_; ///< nullptr for the console
         bool terminal_initialized_;
 
     public:
-        TerminalManager() : terminal_initialized_(false) {}
+        explicit TerminalManager(std::shared_ptr<TerminalBackend> backend = nullptr) :
+            backend_(std::move(backend)), terminal_initialized_(false) {}
         ~TerminalManager() {
             if (terminal_initialized_) {
                 restore_terminal();
             }
         }
 
-        void setup_terminal() {
+        void setup_terminal(const bool alternate_screen = true) {
             if (!terminal_initialized_) {
-                TerminalUtils::init_terminal();
+                TerminalUtils::set_backend(backend_.get());
+                TerminalUtils::init_terminal(alternate_screen);
                 terminal_initialized_ = true;
             }
         }
@@ -135,6 +277,7 @@ namespace tui {
         void restore_terminal() {
             if (terminal_initialized_) {
                 TerminalUtils::restore_terminal();
+                TerminalUtils::set_backend(nullptr);
                 terminal_initialized_ = false;
             }
         }
@@ -145,8 +288,15 @@ namespace tui {
         static std::optional<tui::KeyEvent> get_key_input();
 
         static bool wait_for_input(int timeout_ms);
+        static WaitResult wait(const int timeout_ms) { return TerminalUtils::backend().wait(timeout_ms); }
+        static void wake() { TerminalUtils::backend().wake(); }
+        static bool event_driven() { return TerminalUtils::backend().event_driven(); }
         static bool key_available();
+        static void set_escape_timeout(const int timeout_ms) {
+            TerminalUtils::backend().set_escape_timeout(timeout_ms);
+        }
         static std::pair<int, int> get_terminal_size() { return TerminalUtils::get_terminal_size(); }
+        static std::pair<int, int> refresh_terminal_size() { return TerminalUtils::refresh_terminal_size(); }
     };
 
 } // namespace tui
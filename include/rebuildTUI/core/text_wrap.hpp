@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tui {
+
+    /**
+     * @brief One line of wrapped text, a span of the source string
+     */
+    struct TextLine {
+        size_t begin = 0;
+        size_t length = 0;
+        int width = 0;  ///< Columns the line occupies
+        int indent = 0; ///< Columns of padding that center the line, 0 when not centering
+    };
+
+    /**
+     * @brief Wrapped text together with the source its lines point into
+     */
+    struct WrappedText {
+        std::string text;
+        std::vector<TextLine> lines;
+
+        [[nodiscard]] std::string_view line(const size_t index) const {
+            return std::string_view(text).substr(lines[index].begin, lines[index].length);
+        }
+    };
+
+    /**
+     * @brief Break text into lines of at most width columns
+     *
+     * Lines break at spaces where possible, words wider than the line are split.
+     * Explicit newlines are kept, a trailing one ends in an empty line. Escape
+     * sequences take no room. A width of 0 or less disables wrapping.
+     */
+    [[nodiscard]] std::vector<TextLine> wrap_text(std::string_view text, int width, bool center);
+
+    /**
+     * @brief Small cache of wrap_text() results keyed by text, width and centering
+     *
+     * Footer texts rarely change between frames, the cache wraps each
+     * (text, width, centering) combination once. The oldest entry is dropped
+     * once the cache holds MAX_ENTRIES results.
+     */
+    class WrapCache {
+    public:
+        static constexpr size_t MAX_ENTRIES = 16;
+
+        [[nodiscard]] const WrappedText& get(std::string_view text, int width, bool center);
+
+        void clear() { entries_.clear(); }
+        [[nodiscard]] size_t size() const { return entries_.size(); }
+
+    private:
+        struct Entry {
+            size_t hash;
+            int width;
+            bool center;
+            WrappedText wrapped;
+        };
+
+        std::vector<Entry> entries_;
+    };
+
+} // namespace tui
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "core/width_table.hpp"
+
+namespace tui::unicode {
+
+    /**
+     * @brief Number of terminal columns a code point occupies (0, 1 or 2)
+     *
+     * Two table lookups, no locale or wcwidth involved. Combining marks and format
+     * characters are zero width, East Asian Wide/Fullwidth characters take two columns.
+     */
+    constexpr int code_point_width(const char32_t code_point) {
+        if (code_point > 0x10FFFF) {
+            return 1;
+        }
+        const uint32_t block = detail::WIDTH_STAGE1[code_point >> detail::WIDTH_BLOCK_SHIFT];
+        const uint32_t offset = code_point & ((1u << detail::WIDTH_BLOCK_SHIFT) - 1);
+        const uint32_t packed = detail::WIDTH_STAGE2[(block << (detail::WIDTH_BLOCK_SHIFT - 2)) + offset / 4];
+        return static_cast<int>((packed >> ((offset % 4) * 2)) & 3u);
+    }
+
+    static_assert(code_point_width(U'A') == 1);
+    static_assert(code_point_width(U'\u0301') == 0); // combining acute accent
+    static_assert(code_point_width(U'\u200D') == 0); // zero width joiner
+    static_assert(code_point_width(U'\u4E2D') == 2); // CJK ideograph
+    static_assert(code_point_width(U'\U0001F600') == 2); // emoji
+
+    /**
+     * @brief Decode the UTF-8 sequence at position and advance past it
+     *
+     * Malformed or truncated sequences decode to U+FFFD and consume a single byte.
+     */
+    inline char32_t decode_utf8(const std::string_view text, size_t& position) {
+        constexpr char32_t replacement = 0xFFFD;
+
+        const auto lead = static_cast<unsigned char>(text[position]);
+        if (lead < 0x80) {
+            ++position;
+            return lead;
+        }
+
+        size_t length = 0;
+        char32_t code_point = 0;
+        if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            code_point = lead & 0x1Fu;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            code_point = lead & 0x0Fu;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            code_point = lead & 0x07u;
+        } else {
+            ++position;
+            return replacement;
+        }
+
+        if (position + length > text.size()) {
+            ++position;
+            return replacement;
+        }
+
+        for (size_t i = 1; i < length; ++i) {
+            const auto c = static_cast<unsigned char>(text[position + i]);
+            if ((c & 0xC0) != 0x80) {
+                ++position;
+                return replacement;
+            }
+            code_point = (code_point << 6) | (c & 0x3Fu);
+        }
+
+        position += length;
+        return code_point;
+    }
+
+    /**
+     * @brief Number of terminal columns a UTF-8 string occupies
+     *
+     * Escape sequences (ESC up to the closing 'm') take no space. Plain text is
+     * scanned a block at a time like visible_length(): printable ASCII is counted
+     * from a byte mask, only the lead bytes of other characters are decoded and
+     * go through code_point_width().
+     */
+    size_t display_width(std::string_view text);
+
+    /**
+     * @brief Scalar reference implementation of display_width()
+     */
+    size_t display_width_scalar(std::string_view text);
+
+    /**
+     * @brief Number of visible characters in a UTF-8 string
+     *
+     * Counts UTF-8 lead bytes and skips escape sequences (ESC up to the closing 'm').
+     * Plain text is scanned 32 (AVX2) or 16 (SSE2) bytes at a time, the kernel is
+     * picked once at startup and falls back to a scalar loop elsewhere.
+     */
+    size_t visible_length(std::string_view text);
+
+    /**
+     * @brief Scalar reference implementation of visible_length()
+     */
+    size_t visible_length_scalar(std::string_view text);
+
+    /**
+     * @brief Name of the kernel visible_length() dispatches to ("avx2", "sse2" or "scalar")
+     */
+    const char* visible_length_kernel();
+
+} // namespace tui::unicode
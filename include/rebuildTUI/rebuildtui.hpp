@@ -1,12 +1,18 @@
 #pragma once
 
+#include "core/frame_scheduler.hpp"
 #include "core/input.hpp"
+#include "core/render_stats.hpp"
+#include "core/screen.hpp"
 #include "core/terminal.hpp"
+#include "core/text_wrap.hpp"
 #include "theme/colors.hpp"
 #include "ui/section.hpp"
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <random>
 
 namespace tui {
     /**
@@ -56,6 +62,13 @@ namespace tui {
 
             bool paginate_sections = true;
             int sections_per_page = 15; ///< Number of sections to display per page
+
+            bool scroll_lists = true; ///< Scroll lists with the cursor, false flips whole pages instead
+
+            bool use_alternate_screen = true; ///< Draw on the alternate screen, the shell contents return on exit
+
+            int frame_rate_limit = 60; ///< Frames per second at most, changes in between are merged; 0 for no cap
+            int resize_debounce_ms = 30; ///< Relayout once resizes stopped for this long; 0 for every resize
         };
 
         /**
@@ -86,6 +99,7 @@ namespace tui {
             std::map<char, std::string> custom_shortcuts; ///< Custom keyboard shortcuts
             bool enable_quick_select = true;              ///< Enable number keys for quick selection
             bool enable_vim_keys = false;                 ///< Enable vim-style navigation (hjkl)
+            int escape_timeout_ms = 25; ///< Wait for the rest of an escape sequence before ESC counts as a key
         };
 
         /**
@@ -98,6 +112,7 @@ namespace tui {
         using ExitCallback = std::function<void(const std::vector<Section>& sections)>;
         using CustomCommandCallback = std::function<bool(char key, NavigationState state)>;
         using UpdateCallback = std::function<void()>;
+        using FrameCallback = std::function<void(const FrameStats& frame)>;
 
     private:
         std::vector<Section> sections_;
@@ -114,6 +129,22 @@ namespace tui {
         int previous_width_;
         int previous_height_;
 
+        // Scrolling viewport, index of the first visible section / item
+        size_t section_offset_ = 0;
+        size_t item_offset_ = 0;
+        int pending_scroll_ = 0; ///< Lines the viewport moved since the last frame, replayed as a terminal scroll
+
+        // Selected item count per section, npos until counted
+        mutable std::vector<size_t> selected_counts_;
+
+        // Wrapped description and help text, keyed by text, width and centering
+        mutable WrapCache wrap_cache_;
+
+        // Gradient rendering
+        extras::GradientCache gradient_cache_;
+        std::vector<extras::GradientColor> gradient_scratch_; ///< Shuffled copy for gradient_randomize
+        std::mt19937 gradient_rng_;                           ///< Seeded once per instance
+
         // Event callbacks
         SectionSelectedCallback on_section_selected_;
         ItemToggledCallback on_item_toggled_;
@@ -122,9 +153,126 @@ namespace tui {
         ExitCallback on_exit_;
         CustomCommandCallback on_custom_command_;
         UpdateCallback update_callback_;
+        FrameCallback on_frame_;
+
+        FrameScheduler scheduler_;
+        std::atomic<bool> wake_requested_{false};
+        std::vector<KeyEvent> pending_keys_; ///< Keys drained by process_events(), kept for its capacity
+
+        // Render statistics
+        bool render_stats_enabled_ = false;
+        RenderStatsCollector render_stats_;
+        FrameStats frame_stats_;                                  ///< Frame being measured
+        std::optional<ScopedPhase::Clock::time_point> input_time_; ///< First unanswered key
+
+#ifdef REBUILDTUI_NO_RENDER_STATS
+        static constexpr bool render_stats_active() { return false; }
+#else
+        [[nodiscard]] bool render_stats_active() const { return render_stats_enabled_; }
+#endif
 
         // Terminal management
         std::unique_ptr<TerminalManager> terminal_manager_;
+        ScreenBuffer screen_;
+
+        /**
+         * @brief One formatted row of the section or item list
+         */
+        struct ListRow {
+            std::string text;
+            size_t width = 0; ///< Visible width, a change forces a full frame
+            bool highlighted = false;
+        };
+
+        /**
+         * @brief Screen geometry derived from the terminal size, the layout and the visible rows
+         *
+         * Computed by compute_layout() and reused until a resize, a config change or a
+         * change of the visible list (section, page, scroll position) invalidates it.
+         */
+        struct LayoutState {
+            bool valid = false;
+            int term_height = 0;
+            int term_width = 0;
+            int content_width = 0; ///< Width of the content area inside the border
+            int left_padding = 0;  ///< First column of the content area
+            int header_row = 0;    ///< Row of the title, the underline follows
+            int items_row = 0;     ///< Row of the first list row
+            int items_col = 0;     ///< Column of the list block, centered on the widest visible row
+            size_t row_count = 0;  ///< Visible list rows
+            size_t max_row_width = 0;
+
+            bool border = false;
+            int border_top = 0;
+            int border_left = 0;
+            int border_width = 0;
+            int border_height = 0;
+            int content_bottom = 0; ///< Last row of the border or, without one, of the list
+
+            int footer_top = 0;        ///< First row kept for the footer, the content ends above it
+            int description_row = 0;   ///< First row of the description
+            int description_lines = 0; ///< Wrapped description lines
+            int help_row = 0;          ///< First row of the help text, one blank row below the description
+            int help_lines = 0;        ///< Wrapped help lines
+        };
+
+        /**
+         * @brief What the last full frame actually drew, for partial redraws
+         */
+        struct FrameGeometry {
+            int items_row = 0;              ///< Screen row of the first list row
+            int content_bottom = 0;         ///< Last row used by the border or the list
+            int footer_top = 0;             ///< First row used by the footer
+            std::vector<size_t> row_widths; ///< Visible width of each drawn list row
+        };
+
+        /**
+         * @brief Theme resolved into ready-to-draw styles and strings
+         *
+         * Rebuilt by compile_theme() whenever the theme changes, the render path only copies from it.
+         */
+        struct CompiledTheme {
+            /**
+             * @brief One palette role as a cell style and as the equivalent SGR sequence
+             */
+            struct Role {
+                CellStyle style;
+                std::string sgr; ///< Empty when colors are disabled
+            };
+
+            Role border;
+            Role header_text;
+            Role header_border;
+            Role selected_item;
+            Role unselected_item;
+
+            // Border glyphs
+            std::string top_left, top_right, bottom_left, bottom_right, vertical;
+            std::string top_edge;    ///< Complete top border line for edge_width
+            std::string bottom_edge; ///< Complete bottom border line for edge_width
+            int edge_width = -1;     ///< Border width the edges were built for
+
+            // Prefixes
+            std::string selected_prefix;
+            std::string unselected_prefix;
+            std::string highlighted_prefix;
+            std::string highlight_padding; ///< Blanks as wide as highlighted_prefix
+            size_t selected_prefix_width = 0;
+            size_t unselected_prefix_width = 0;
+            size_t highlight_width = 0;
+        };
+
+        CompiledTheme theme_;
+        ColorDepth color_depth_ = ColorDepth::TRUECOLOR; ///< What theme_ and gradients are reduced to
+        std::string border_horizontal_; ///< Horizontal border glyph, kept to rebuild the edges on resize
+
+        LayoutState layout_;
+
+        // Partial redraw state, needs_redraw_ still forces a full frame
+        FrameGeometry frame_;
+        std::vector<size_t> dirty_rows_;
+        bool footer_dirty_ = false;
+        int footer_height_ = 5; ///< Rows from the footer top to the last terminal row, set by compute_layout()
 
     public:
         NavigationTUI();
@@ -190,6 +338,18 @@ namespace tui {
         void set_custom_command_callback(CustomCommandCallback callback);
         void set_update_callback(UpdateCallback callback);
 
+        /**
+         * @brief Called after every drawn frame with its statistics, enables render statistics
+         */
+        void set_frame_callback(FrameCallback callback);
+
+        /**
+         * @brief Draw to and read keys from the given backend instead of the console
+         *
+         * Takes effect the next time run() sets up the terminal, nullptr goes back to the console.
+         */
+        void set_terminal_backend(std::shared_ptr<TerminalBackend> backend);
+
         /**
          * @brief Force items to be refreshed/redrawn during the next update cycle
          */
@@ -226,12 +386,32 @@ namespace tui {
          */
         [[nodiscard]] const Config& get_config() const;
 
+        /**
+         * @brief Frame timing and output statistics
+         *
+         * Off by default; while off render() reads no clocks. Building with
+         * REBUILDTUI_NO_RENDER_STATS (CMake option ENABLE_RENDER_STATS=OFF) compiles
+         * the measurements out entirely.
+         */
+        void enable_render_stats(bool enable);
+        [[nodiscard]] bool render_stats_enabled() const { return render_stats_active(); }
+        [[nodiscard]] RenderStats get_render_stats() const { return render_stats_.snapshot(); }
+        void reset_render_stats() { render_stats_.reset(); }
+
         /*
          * Other methods
          */
         void run();
         void exit();
 
+        /**
+         * @brief Wake the event loop from another thread
+         *
+         * The loop runs the update callback and redraws the screen right away instead
+         * of at its next wakeup. Meant for background threads that changed what is shown.
+         */
+        void wake();
+
         /**
          * @brief Horizontal centering to text
          */
@@ -255,8 +435,52 @@ namespace tui {
         void process_events();
 
         void handle_input(Key key, char character);
-        void draw_border(int top, int left, int width, int height) const;
+        void draw_border(int top, int left, int width, int height);
+        void compile_theme();
+
+        /**
+         * @brief Relayout if the terminal size changed
+         */
+        void check_terminal_size();
+
+        /**
+         * @brief Whether anything changed since the last frame
+         */
+        [[nodiscard]] bool has_pending_changes() const {
+            return needs_redraw_ || !dirty_rows_.empty() || footer_dirty_;
+        }
+
+        /**
+         * @brief Complete frame_stats_ after a measured frame, record it and call the frame callback
+         */
+        void finish_frame_stats();
         void render();
+        void render_full_frame();
+
+        /**
+         * @brief Recompute layout_ for the current terminal size and visible list
+         */
+        void compute_layout();
+        void invalidate_layout() { layout_.valid = false; }
+
+        /**
+         * @brief Repaint only the rows marked dirty since the last frame
+         * @return false if the change does not fit the last frame's geometry and a full frame is needed
+         */
+        bool render_dirty_rows();
+
+        /**
+         * @brief Mark a list row (relative to the current page) for repaint
+         */
+        void mark_row_dirty(size_t row);
+
+        /**
+         * @brief Forget the screen contents, e.g. after a user callback printed to the terminal
+         *
+         * Callbacks may also have changed sections or selections, so the cached counters and
+         * layout are dropped as well.
+         */
+        void invalidate_screen();
 
         /**
          * @brief Render section selection screen
@@ -268,6 +492,13 @@ namespace tui {
          */
         void render_item_selection(int start_row, int left_padding, int content_width);
 
+        /**
+         * @brief List row helpers shared by both screens
+         */
+        [[nodiscard]] ListRow build_list_row(size_t row) const;
+        void draw_list_row(int row, int col, const ListRow& data);
+        void render_list_rows(size_t row_count);
+
         /**
          * @brief Render header with title
          */
@@ -277,7 +508,20 @@ namespace tui {
          * @brief Render footer with help text and page info
          */
         // void render_footer(int term_height, int left_padding, int content_width) const;
-        void render_footer(int term_height, int left_padding, int content_width, const SelectableItem* item);
+        void render_footer(int left_padding, int content_width, const SelectableItem* item);
+
+        /**
+         * @brief Footer helpers
+         */
+        [[nodiscard]] const SelectableItem* get_current_item() const;
+        [[nodiscard]] std::string get_description_text(const SelectableItem* item) const;
+        [[nodiscard]] std::string get_help_text() const;
+        [[nodiscard]] std::pair<int, int> get_footer_lines(int content_width, const SelectableItem* item) const;
+
+        /**
+         * @brief Draw wrapped text downwards from top_row
+         */
+        void draw_wrapped(int top_row, int left_padding, const WrappedText& wrapped);
 
         /**
          * @brief Handle input in section selection mode
@@ -294,6 +538,16 @@ namespace tui {
          */
         void move_selection_up();
         void move_selection_down();
+
+        /**
+         * @brief Same result as |rows| single moves (negative is up), with one scroll and one page change
+         */
+        void move_selection_by(std::ptrdiff_t rows);
+
+        /**
+         * @brief Same result as |pages| next_page() / previous_page() calls (negative is back)
+         */
+        void turn_pages(int pages);
         void select_current_item();
         void toggle_current_item();
         void handle_number_input(char digit);
@@ -301,10 +555,40 @@ namespace tui {
         /**
          * @brief Pagination helpers
          */
-        [[nodiscard]] int calculate_total_pages() const;
+        [[nodiscard]] int calculate_total_pages() const { return calculate_total_pages(current_state_); }
+        [[nodiscard]] int calculate_total_pages(NavigationState state) const;
         [[nodiscard]] std::pair<size_t, size_t> get_current_page_bounds() const;
         void clamp_selection();
 
+        /**
+         * @brief Viewport helpers, in paging mode the viewport is the current page
+         */
+        [[nodiscard]] size_t get_list_size(NavigationState state) const;
+        [[nodiscard]] size_t get_viewport_rows(NavigationState state) const;
+        [[nodiscard]] size_t get_list_offset(NavigationState state) const;
+        [[nodiscard]] int get_viewport_page(NavigationState state) const;
+
+        /**
+         * @brief Move the viewport of the current list so it starts at the given entry
+         */
+        void scroll_to(size_t offset) { scroll_to(current_state_, offset); }
+
+        /**
+         * @brief Move the viewport of the section or item list, whichever is shown
+         */
+        void scroll_to(NavigationState state, size_t offset);
+
+        /**
+         * @brief Select an entry of the current list by its global index, flipping the page or scrolling to it
+         */
+        void show_entry(size_t index);
+
+        /**
+         * @brief Selected item count of a section, counted once and then kept up to date
+         */
+        [[nodiscard]] size_t get_selected_count(size_t section_index) const;
+        void invalidate_selected_counts() { selected_counts_.clear(); }
+
         /**
          * @brief Rendering helpers
          */
@@ -313,7 +597,7 @@ namespace tui {
         [[nodiscard]] std::string format_item_with_theme(const SelectableItem& item, bool is_selected) const;
         [[nodiscard]] std::string get_page_info_string() const;
 
-        void apply_gradient_text(const std::string& text, int row, int col) const;
+        void apply_gradient_text(const std::string& text, int row, int col);
 
         /**
          * @brief Layout calculation
@@ -322,7 +606,15 @@ namespace tui {
         // std::tuple<int, int, int, int> get_content_area() const;
         // std::pair<int, int> apply_centering_offset(int row, int col) const;
         [[nodiscard]] int get_effective_content_width(int) const;
-        [[nodiscard]] int get_effective_content_height() const;
+        [[nodiscard]] int get_effective_content_height(size_t row_count) const;
+
+        /**
+         * @brief Vertical placement of the title, the list and the border for layout.row_count rows
+         *
+         * Uses layout.term_height and layout.footer_top; shared by compute_layout() and get_viewport_rows()
+         * so the viewport budget always matches what gets drawn.
+         */
+        void place_content(LayoutState& layout) const;
         // bool should_center_horizontally() const;
         // bool should_center_vertically() const;
 
@@ -364,6 +656,10 @@ namespace tui {
         NavigationTUI::CustomCommandCallback custom_command_callback_;
         NavigationTUI::UpdateCallback update_callback_;
 
+        std::shared_ptr<TerminalBackend> terminal_backend_;
+        NavigationTUI::FrameCallback frame_callback_;
+        bool render_stats_ = false;
+
     public:
         /*
          * TODO: may I move theme_* to styles.hpp (or extras.hpp)?
@@ -394,6 +690,10 @@ namespace tui {
         NavigationBuilder& layout_padding(int vertical_padding);
         NavigationBuilder& layout_auto_resize(bool enable);
         NavigationBuilder& layout_borders(bool show);
+        NavigationBuilder& layout_alternate_screen(bool enable);
+        NavigationBuilder& layout_scrolling(bool enable);
+        NavigationBuilder& layout_frame_rate(int frames_per_second);
+        NavigationBuilder& layout_resize_debounce(int milliseconds);
         NavigationBuilder& layout_items_per_page(int count);
         NavigationBuilder& layout_sections_per_page(int count);
         NavigationBuilder& paginate_sections(bool paginate);
@@ -413,6 +713,7 @@ namespace tui {
          */
         NavigationBuilder& keys_quick_select(bool enable);
         NavigationBuilder& keys_vim_style(bool enable);
+        NavigationBuilder& keys_escape_timeout(int milliseconds);
         NavigationBuilder& keys_custom_shortcut(char key, const std::string& description);
 
         /**
@@ -433,6 +734,17 @@ namespace tui {
         NavigationBuilder& on_custom_command(NavigationTUI::CustomCommandCallback callback);
         NavigationBuilder& on_update(NavigationTUI::UpdateCallback callback);
 
+        /**
+         * @brief Terminal backend, e.g. a HeadlessBackend for benchmarks without a TTY
+         */
+        NavigationBuilder& terminal_backend(std::shared_ptr<TerminalBackend> backend);
+
+        /**
+         * @brief Render statistics, see NavigationTUI::enable_render_stats()
+         */
+        NavigationBuilder& render_stats(bool enable);
+        NavigationBuilder& on_frame(NavigationTUI::FrameCallback callback);
+
         /**
          * @brief Pre-configured themes
          */
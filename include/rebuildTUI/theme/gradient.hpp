@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <tuple>
 #include <vector>
 
 
@@ -71,9 +73,46 @@ namespace tui::extras {
 
         [[nodiscard]] color get_color() const { return std::make_tuple(this->r_, this->g_, this->b_); };
 
+        /**
+         * @brief Round each channel to a multiple of step, so neighbouring cells can share one color run
+         */
+        [[nodiscard]] GradientColor quantized(uint8_t step) const;
+
+        bool operator==(const GradientColor& other) const {
+            return r_ == other.r_ && g_ == other.g_ && b_ == other.b_;
+        }
+        bool operator!=(const GradientColor& other) const { return !(*this == other); }
+
     private:
         uint8_t r_;
         uint8_t g_;
         uint8_t b_;
     };
+
+    /**
+     * @brief Lookup table of quantized gradients keyed by preset and length
+     *
+     * from_preset() allocates and interpolates on every call, the cache does it
+     * once per (preset, length) pair. Least recently built entries are dropped
+     * once the cache holds MAX_ENTRIES tables.
+     */
+    class GradientCache {
+    public:
+        static constexpr size_t MAX_ENTRIES = 32;
+        static constexpr uint8_t QUANTIZATION_STEP = 8; ///< 5 bits per channel, invisible on a gradient
+
+        [[nodiscard]] const std::vector<GradientColor>& get(const GradientPreset& preset, int steps);
+
+        void clear() { entries_.clear(); }
+        [[nodiscard]] size_t size() const { return entries_.size(); }
+
+    private:
+        struct Entry {
+            GradientPreset preset;
+            int steps;
+            std::vector<GradientColor> colors;
+        };
+
+        std::vector<Entry> entries_;
+    };
 } // namespace tui::extras
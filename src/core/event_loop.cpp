@@ -0,0 +1,147 @@
+#include "core/event_loop.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#endif
+
+namespace tui {
+
+#ifdef __linux__
+    namespace {
+        constexpr std::array<int, 3> HANDLED_SIGNALS = {SIGWINCH, SIGTERM, SIGINT};
+
+        std::atomic<int> signal_pipe{-1}; ///< Write end of the open loop's self-pipe, -1 while none is open
+
+        // Runs on whichever thread the kernel picked, so it only hands the signal number to the loop
+        void forward_signal(const int signal) {
+            const int saved_errno = errno;
+            if (const int fd = signal_pipe.load(); fd >= 0) {
+                const auto byte = static_cast<unsigned char>(signal);
+                [[maybe_unused]] const ssize_t written = write(fd, &byte, 1);
+            }
+            errno = saved_errno;
+        }
+    } // namespace
+
+    bool EventLoop::open(const int input_fd) {
+        if (is_open()) {
+            return true;
+        }
+
+        // Signal dispositions are process-wide, only one loop can own them
+        std::array<int, 2> pipe_fds{-1, -1};
+        if (pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC) != 0) {
+            return false;
+        }
+        int expected = -1;
+        if (!signal_pipe.compare_exchange_strong(expected, pipe_fds[1])) {
+            ::close(pipe_fds[0]);
+            ::close(pipe_fds[1]);
+            return false;
+        }
+        signal_fd_ = pipe_fds[0];
+        signal_write_fd_ = pipe_fds[1];
+
+        // A handler rather than a blocked signal and a signalfd: the mask is per thread, and a signal the
+        // kernel hands to a thread that has not blocked it would otherwise never reach the loop
+        struct sigaction action {};
+        action.sa_handler = forward_signal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        for (size_t i = 0; i < HANDLED_SIGNALS.size(); ++i) {
+            sigaction(HANDLED_SIGNALS[i], &action, &previous_actions_[i]);
+        }
+        handlers_installed_ = true;
+
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        input_fd_ = input_fd;
+
+        bool ok = epoll_fd_ >= 0 && wake_fd_ >= 0;
+        for (const int fd : {input_fd_, signal_fd_, wake_fd_}) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            ok = ok && epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == 0;
+        }
+
+        if (!ok) {
+            close();
+        }
+        return ok;
+    }
+
+    void EventLoop::close() {
+        // Put the previous dispositions back first, a signal after this point is no longer ours
+        if (handlers_installed_) {
+            for (size_t i = 0; i < HANDLED_SIGNALS.size(); ++i) {
+                sigaction(HANDLED_SIGNALS[i], &previous_actions_[i], nullptr);
+            }
+            handlers_installed_ = false;
+        }
+        if (signal_write_fd_ >= 0) {
+            signal_pipe.store(-1);
+        }
+
+        for (int* fd : {&epoll_fd_, &signal_fd_, &signal_write_fd_, &wake_fd_}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+        input_fd_ = -1;
+    }
+
+    WaitResult EventLoop::wait(const int timeout_ms) {
+        WaitResult result;
+        std::array<epoll_event, 3> events{};
+
+        const int count = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), timeout_ms);
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[static_cast<size_t>(i)].data.fd;
+
+            if (fd == input_fd_) {
+                result.input = true;
+            } else if (fd == wake_fd_) {
+                uint64_t value;
+                while (read(wake_fd_, &value, sizeof(value)) > 0) {
+                }
+                result.woken = true;
+            } else if (fd == signal_fd_) {
+                unsigned char signal = 0;
+                while (read(signal_fd_, &signal, 1) == 1) {
+                    if (signal == SIGWINCH) {
+                        result.resized = true;
+                    } else {
+                        result.terminate_signal = signal;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    void EventLoop::wake() const {
+        if (wake_fd_ >= 0) {
+            const uint64_t one = 1;
+            [[maybe_unused]] const ssize_t written = write(wake_fd_, &one, sizeof(one));
+        }
+    }
+#else
+    bool EventLoop::open(int /*input_fd*/) { return false; }
+
+    void EventLoop::close() {}
+
+    WaitResult EventLoop::wait(int /*timeout_ms*/) { return {}; }
+
+    void EventLoop::wake() const {}
+#endif
+
+} // namespace tui
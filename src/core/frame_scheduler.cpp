@@ -0,0 +1,50 @@
+#include "core/frame_scheduler.hpp"
+#include <algorithm>
+
+namespace tui {
+
+    void FrameScheduler::set_frame_rate(const int frames_per_second) {
+        interval_ = frames_per_second > 0
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / frames_per_second
+            : Clock::duration::zero();
+    }
+
+    void FrameScheduler::request(const Source source, const Clock::time_point now) {
+        auto& since = source == Source::INPUT ? input_since_ : timer_since_;
+        if (!since) {
+            since = now;
+        }
+    }
+
+    FrameScheduler::Clock::time_point FrameScheduler::deadline() const {
+        const Clock::time_point next_slot = last_frame_ ? *last_frame_ + interval_ : Clock::time_point::min();
+
+        Clock::time_point result = Clock::time_point::max();
+        if (input_since_) {
+            result = std::max(next_slot, *input_since_);
+        }
+        if (timer_since_) {
+            result = std::min(result, std::max(next_slot, *timer_since_ + interval_));
+        }
+        return result;
+    }
+
+    int FrameScheduler::milliseconds_until_due(const Clock::time_point now) const {
+        if (!pending()) {
+            return -1;
+        }
+
+        const Clock::time_point due_at = deadline();
+        if (due_at <= now) {
+            return 0;
+        }
+        return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(due_at - now).count());
+    }
+
+    void FrameScheduler::frame_drawn(const Clock::time_point now) {
+        last_frame_ = now;
+        input_since_.reset();
+        timer_since_.reset();
+    }
+
+} // namespace tui
@@ -0,0 +1,464 @@
+#include "core/headless.hpp"
+#include <algorithm>
+#include "core/unicode.hpp"
+
+namespace tui {
+
+    namespace {
+        // Numeric CSI parameters, missing ones are 0
+        std::vector<int> parse_parameters(const std::string_view parameters) {
+            std::vector<int> values{0};
+            for (const char c : parameters) {
+                if (c == ';') {
+                    values.push_back(0);
+                } else if (c >= '0' && c <= '9') {
+                    values.back() = values.back() * 10 + (c - '0');
+                }
+            }
+            return values;
+        }
+
+        // Bytes in the UTF-8 sequence started by lead, 1 for anything that is not a lead byte
+        size_t utf8_length(const unsigned char lead) {
+            if ((lead & 0xE0) == 0xC0) {
+                return 2;
+            }
+            if ((lead & 0xF0) == 0xE0) {
+                return 3;
+            }
+            if ((lead & 0xF8) == 0xF0) {
+                return 4;
+            }
+            return 1;
+        }
+    } // namespace
+
+    HeadlessBackend::HeadlessBackend(const int rows, const int cols) :
+        rows_(std::max(1, rows)), cols_(std::max(1, cols)),
+        grid_(static_cast<size_t>(rows_) * static_cast<size_t>(cols_)) {}
+
+    size_t HeadlessBackend::write(const std::string_view bytes) {
+        if (recording_) {
+            output_.append(bytes.data(), bytes.size());
+        }
+        total_bytes_ += bytes.size();
+        ++total_writes_;
+
+        if (pending_.empty()) {
+            feed(bytes);
+        } else {
+            std::string joined = std::move(pending_);
+            pending_.clear();
+            joined.append(bytes.data(), bytes.size());
+            feed(joined);
+        }
+        return bytes.size();
+    }
+
+    std::optional<KeyEvent> HeadlessBackend::read_key() {
+        if (!released_ || events_.empty() || events_.front().rows > 0) {
+            return std::nullopt;
+        }
+
+        const KeyEvent key = events_.front().key;
+        events_.pop_front();
+        released_ = false;
+        return key;
+    }
+
+    bool HeadlessBackend::wait_for_input(const int timeout_ms) {
+        const WaitResult result = wait(timeout_ms);
+        return result.input || result.resized;
+    }
+
+    WaitResult HeadlessBackend::wait(int /*timeout_ms*/) {
+        WaitResult result;
+        while (!released_ && !events_.empty() && events_.front().rows > 0) {
+            resize(events_.front().rows, events_.front().cols);
+            events_.pop_front();
+            result.resized = true;
+        }
+
+        if (!events_.empty() && events_.front().rows == 0) {
+            released_ = true;
+        }
+        result.input = released_;
+        return result;
+    }
+
+    void HeadlessBackend::push_key(const Key key, const char character) {
+        events_.push_back(Event{KeyEvent(key, character)});
+    }
+
+    void HeadlessBackend::push_keys(const std::string_view characters) {
+        for (const char c : characters) {
+            auto [key, character] = Input::map_character(static_cast<unsigned char>(c));
+            push_key(key, character);
+        }
+    }
+
+    void HeadlessBackend::push_resize(const int rows, const int cols) {
+        events_.push_back(Event{KeyEvent{}, std::max(1, rows), std::max(1, cols)});
+    }
+
+    void HeadlessBackend::resize(int rows, int cols) {
+        rows = std::max(1, rows);
+        cols = std::max(1, cols);
+        if (rows == rows_ && cols == cols_) {
+            return;
+        }
+
+        const auto copy = [&](const std::vector<Cell>& from) {
+            std::vector<Cell> to(static_cast<size_t>(rows) * static_cast<size_t>(cols));
+            for (int r = 1; r <= std::min(rows, rows_); ++r) {
+                for (int c = 1; c <= std::min(cols, cols_); ++c) {
+                    to[static_cast<size_t>(r - 1) * static_cast<size_t>(cols) + static_cast<size_t>(c - 1)] =
+                        from[index(r, c)];
+                }
+            }
+            return to;
+        };
+
+        grid_ = copy(grid_);
+        if (alternate_screen_) {
+            primary_ = copy(primary_);
+        }
+
+        rows_ = rows;
+        cols_ = cols;
+        scroll_top_ = 1;
+        scroll_bottom_ = 0;
+        move_to(row_, col_);
+    }
+
+    const Cell& HeadlessBackend::at(const int row, const int col) const {
+        static const Cell outside;
+        if (row < 1 || row > rows_ || col < 1 || col > cols_) {
+            return outside;
+        }
+        return grid_[index(row, col)];
+    }
+
+    std::string HeadlessBackend::line(const int row) const {
+        std::string text;
+        if (row < 1 || row > rows_) {
+            return text;
+        }
+
+        for (int col = 1; col <= cols_; ++col) {
+            text += grid_[index(row, col)].glyph;
+        }
+        text.erase(text.find_last_not_of(' ') + 1);
+        return text;
+    }
+
+    std::string HeadlessBackend::screen_text() const {
+        std::string text;
+        for (int row = 1; row <= rows_; ++row) {
+            if (row > 1) {
+                text += '\n';
+            }
+            text += line(row);
+        }
+        return text;
+    }
+
+    void HeadlessBackend::feed(const std::string_view bytes) {
+        size_t i = 0;
+        while (i < bytes.size()) {
+            const auto c = static_cast<unsigned char>(bytes[i]);
+
+            if (c == 0x1B) {
+                if (i + 1 >= bytes.size()) {
+                    break;
+                }
+
+                const char kind = bytes[i + 1];
+                if (kind == '[') {
+                    size_t end = i + 2;
+                    while (end < bytes.size() && (bytes[end] < 0x40 || bytes[end] > 0x7E)) {
+                        ++end;
+                    }
+                    if (end >= bytes.size()) {
+                        break;
+                    }
+                    handle_csi(bytes.substr(i + 2, end - i - 2), bytes[end]);
+                    i = end + 1;
+                } else if (kind == ']') {
+                    // OSC, terminated by BEL or ST
+                    size_t end = i + 2;
+                    while (end < bytes.size() && bytes[end] != '\a' &&
+                           !(bytes[end] == 0x1B && end + 1 < bytes.size() && bytes[end + 1] == '\\')) {
+                        ++end;
+                    }
+                    if (end >= bytes.size()) {
+                        break;
+                    }
+                    i = end + (bytes[end] == '\a' ? 1 : 2);
+                } else if (kind == '(' || kind == ')') {
+                    if (i + 2 >= bytes.size()) {
+                        break;
+                    }
+                    i += 3;
+                } else {
+                    if (kind == '7') {
+                        saved_row_ = row_;
+                        saved_col_ = col_;
+                    } else if (kind == '8') {
+                        move_to(saved_row_, saved_col_);
+                    }
+                    i += 2;
+                }
+                continue;
+            }
+
+            if (c < 0x20 || c == 0x7F) {
+                switch (c) {
+                case '\r':
+                    move_to(row_, 1);
+                    break;
+                case '\n':
+                    pending_wrap_ = false;
+                    line_feed();
+                    break;
+                case '\b':
+                    move_to(row_, col_ - 1);
+                    break;
+                case '\t':
+                    move_to(row_, std::min(cols_, ((col_ - 1) / 8 + 1) * 8 + 1));
+                    break;
+                default:
+                    break;
+                }
+                ++i;
+                continue;
+            }
+
+            const size_t length = utf8_length(c);
+            if (i + length > bytes.size()) {
+                break;
+            }
+
+            size_t next = i;
+            const int width = unicode::code_point_width(unicode::decode_utf8(bytes, next));
+            put_glyph(bytes.substr(i, next - i), width);
+            i = next;
+        }
+
+        if (i < bytes.size()) {
+            pending_.assign(bytes.data() + i, bytes.size() - i);
+        }
+    }
+
+    void HeadlessBackend::handle_csi(const std::string_view parameters, const char final) {
+        if (!parameters.empty() && parameters.front() == '?') {
+            if (final == 'h' || final == 'l') {
+                handle_private_mode(parameters.substr(1), final == 'h');
+            }
+            return;
+        }
+        if (parameters.find_first_of("$>=<!") != std::string_view::npos) {
+            // Queries and other intermediates do not change the screen
+            return;
+        }
+
+        const std::vector<int> values = parse_parameters(parameters);
+        const int n = std::max(1, values[0]);
+
+        switch (final) {
+        case 'A':
+            move_to(row_ - n, col_);
+            break;
+        case 'B':
+            move_to(row_ + n, col_);
+            break;
+        case 'C':
+            move_to(row_, col_ + n);
+            break;
+        case 'D':
+            move_to(row_, col_ - n);
+            break;
+        case 'E':
+            move_to(row_ + n, 1);
+            break;
+        case 'F':
+            move_to(row_ - n, 1);
+            break;
+        case 'G':
+            move_to(row_, n);
+            break;
+        case 'd':
+            move_to(n, col_);
+            break;
+        case 'H':
+        case 'f':
+            move_to(n, values.size() > 1 ? std::max(1, values[1]) : 1);
+            break;
+        case 'J':
+            if (values[0] == 0) {
+                erase(row_, col_, rows_, cols_);
+            } else if (values[0] == 1) {
+                erase(1, 1, row_, col_);
+            } else {
+                erase(1, 1, rows_, cols_);
+            }
+            break;
+        case 'K':
+            if (values[0] == 0) {
+                erase(row_, col_, row_, cols_);
+            } else if (values[0] == 1) {
+                erase(row_, 1, row_, col_);
+            } else {
+                erase(row_, 1, row_, cols_);
+            }
+            break;
+        case 'X':
+            erase(row_, col_, row_, std::min(cols_, col_ + n - 1));
+            break;
+        case 'S':
+            scroll_region(n);
+            break;
+        case 'T':
+            scroll_region(-n);
+            break;
+        case 'r': {
+            const int top = std::max(1, values[0]);
+            const int last = values.size() > 1 && values[1] > 0 ? std::min(values[1], rows_) : rows_;
+            if (top < last) {
+                scroll_top_ = top;
+                scroll_bottom_ = last == rows_ ? 0 : last;
+            }
+            move_to(1, 1);
+            break;
+        }
+        case 'm':
+            apply_sgr(parameters, style_);
+            break;
+        case 's':
+            saved_row_ = row_;
+            saved_col_ = col_;
+            break;
+        case 'u':
+            move_to(saved_row_, saved_col_);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void HeadlessBackend::handle_private_mode(const std::string_view parameters, const bool enable) {
+        for (const int mode : parse_parameters(parameters)) {
+            if (mode == 25) {
+                cursor_visible_ = enable;
+            } else if (mode == 1049 && enable != alternate_screen_) {
+                // Save the cursor and switch to a blank alternate screen, leaving restores both
+                if (enable) {
+                    saved_row_ = row_;
+                    saved_col_ = col_;
+                    primary_ = grid_;
+                    std::fill(grid_.begin(), grid_.end(), Cell{});
+                } else {
+                    grid_ = std::move(primary_);
+                    primary_.clear();
+                    move_to(saved_row_, saved_col_);
+                }
+                alternate_screen_ = enable;
+            }
+        }
+    }
+
+    void HeadlessBackend::put_glyph(const std::string_view glyph, const int width) {
+        if (width == 0) {
+            // Combining marks join the glyph before the cursor
+            const int col = pending_wrap_ ? col_ : col_ - 1;
+            if (col >= 1) {
+                Cell& cell = grid_[index(row_, col)];
+                if (cell.glyph.empty() && col > 1) {
+                    grid_[index(row_, col - 1)].glyph.append(glyph.data(), glyph.size());
+                } else {
+                    cell.glyph.append(glyph.data(), glyph.size());
+                }
+            }
+            return;
+        }
+
+        if (pending_wrap_ || (width == 2 && col_ == cols_ && cols_ > 1)) {
+            pending_wrap_ = false;
+            col_ = 1;
+            line_feed();
+        }
+
+        const auto put = [&](const int col, std::string_view text) {
+            Cell& cell = grid_[index(row_, col)];
+            // Overwriting half of a wide glyph blanks the other half
+            if (cell.glyph.empty() && col > 1) {
+                grid_[index(row_, col - 1)] = blank();
+            } else if (col < cols_ && grid_[index(row_, col + 1)].glyph.empty()) {
+                grid_[index(row_, col + 1)] = blank();
+            }
+            cell.glyph.assign(text.data(), text.size());
+            cell.style = style_;
+        };
+
+        put(col_, glyph);
+        if (width == 2 && col_ < cols_) {
+            put(col_ + 1, {});
+        }
+
+        col_ += width;
+        if (col_ > cols_) {
+            col_ = cols_;
+            pending_wrap_ = true;
+        }
+    }
+
+    void HeadlessBackend::line_feed() {
+        const int bottom = scroll_bottom_ > 0 ? scroll_bottom_ : rows_;
+        if (row_ == bottom) {
+            scroll_region(1);
+        } else if (row_ < rows_) {
+            ++row_;
+        }
+    }
+
+    void HeadlessBackend::scroll_region(const int lines) {
+        const int top = scroll_top_;
+        const int bottom = scroll_bottom_ > 0 ? scroll_bottom_ : rows_;
+        const int height = bottom - top + 1;
+        const int count = std::min(std::abs(lines), height);
+        const auto row_begin = [&](const int row) {
+            return grid_.begin() + static_cast<std::ptrdiff_t>(index(row, 1));
+        };
+
+        if (lines > 0) {
+            std::move(row_begin(top + count), row_begin(bottom) + cols_, row_begin(top));
+            erase(bottom - count + 1, 1, bottom, cols_);
+        } else if (lines < 0) {
+            std::move_backward(row_begin(top), row_begin(bottom - count + 1), row_begin(bottom) + cols_);
+            erase(top, 1, top + count - 1, cols_);
+        }
+    }
+
+    void HeadlessBackend::erase(const int from_row, const int from_col, const int to_row, const int to_col) {
+        const size_t first = index(from_row, from_col);
+        const size_t last = index(to_row, to_col);
+        if (first <= last) {
+            std::fill(grid_.begin() + static_cast<std::ptrdiff_t>(first),
+                      grid_.begin() + static_cast<std::ptrdiff_t>(last) + 1, blank());
+        }
+    }
+
+    void HeadlessBackend::move_to(const int row, const int col) {
+        row_ = std::clamp(row, 1, rows_);
+        col_ = std::clamp(col, 1, cols_);
+        pending_wrap_ = false;
+    }
+
+    Cell HeadlessBackend::blank() const {
+        // Erased cells take the current background (BCE)
+        Cell cell;
+        cell.style.bg = style_.bg;
+        return cell;
+    }
+
+} // namespace tui
@@ -1,4 +1,5 @@
 #include "core/input.hpp"
+#include "core/key_parser.hpp"
 
 #ifdef _WIN32
 #include <conio.h>
@@ -9,47 +10,142 @@
 #include <termios.h>
 #include <unistd.h>
 #endif
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
 
 namespace tui {
 
-    int Input::get_key() {
+    namespace {
 #ifdef _WIN32
-        return _getch();
-#else
-        char c;
-        if (read(STDIN_FILENO, &c, 1) > 0) {
-            return static_cast<unsigned char>(c);
+        Key map_scan_code(const int code) {
+            switch (code) {
+            case 72:
+                return Key::ARROW_UP;
+            case 80:
+                return Key::ARROW_DOWN;
+            case 75:
+                return Key::ARROW_LEFT;
+            case 77:
+                return Key::ARROW_RIGHT;
+            case 71:
+                return Key::HOME;
+            case 79:
+                return Key::END;
+            case 73:
+                return Key::PAGE_UP;
+            case 81:
+                return Key::PAGE_DOWN;
+            case 82:
+                return Key::INSERT;
+            case 83:
+                return Key::KEY_DELETE;
+            case 59:
+            case 60:
+            case 61:
+            case 62:
+            case 63:
+            case 64:
+            case 65:
+            case 66:
+            case 67:
+            case 68:
+                return static_cast<Key>(static_cast<int>(Key::F1) + code - 59);
+            case 133:
+                return Key::F11;
+            case 134:
+                return Key::F12;
+            default:
+                return Key::UNKNOWN;
+            }
         }
-        return EOF;
 #endif
-    }
+    } // namespace
+
+    InputBuffer Input::buffer_;
+    std::chrono::milliseconds Input::escape_timeout_{25};
+    std::optional<std::chrono::steady_clock::time_point> Input::escape_since_;
 
-    bool Input::key_available() {
+    bool Input::fill_buffer() {
 #ifdef _WIN32
-        return _kbhit();
+        const size_t before = buffer_.size();
+        while (buffer_.size() < InputBuffer::CAPACITY && _kbhit()) {
+            buffer_.push(static_cast<char>(_getch()));
+        }
+        return buffer_.size() > before;
 #else
-        fd_set readfds;
-        timeval timeout{};
-
-        FD_ZERO(&readfds);
-        FD_SET(STDIN_FILENO, &readfds);
+        // Raw mode sets VMIN = 0, VTIME = 0, so read() returns right away with whatever is there
+        bool added = false;
+        while (true) {
+            const auto [data, space] = buffer_.write_span();
+            if (space == 0) {
+                break;
+            }
 
-        timeout.tv_sec = 0;
-        timeout.tv_usec = 0;
+            const ssize_t count = read(STDIN_FILENO, data, space);
+            if (count <= 0) {
+                break;
+            }
+            buffer_.commit(static_cast<size_t>(count));
+            added = true;
 
-        const int result = select(STDIN_FILENO + 1, &readfds, nullptr, nullptr, &timeout);
-        return result > 0;
+            // Only a read that filled the span up to the end of the ring can have more waiting
+            if (static_cast<size_t>(count) < space) {
+                break;
+            }
+        }
+        return added;
 #endif
     }
 
-    bool Input::wait_for_input(int timeout_ms) {
+    int Input::get_key() {
+        while (buffer_.empty() && !fill_buffer()) {
+            if (!poll_input(-1)) {
+                return EOF;
+            }
+        }
+        return buffer_.pop();
+    }
+
+    bool Input::key_available() { return !buffer_.empty() || fill_buffer(); }
+
+    int Input::milliseconds_until_ready() {
+        if (buffer_.empty()) {
+            return -1;
+        }
+        if (!escape_since_) {
+            return 0;
+        }
+
+        const auto left = escape_timeout_ - (std::chrono::steady_clock::now() - *escape_since_);
+        return static_cast<int>(std::max<int64_t>(0, std::chrono::ceil<std::chrono::milliseconds>(left).count()));
+    }
+
+    bool Input::wait_for_input(const int timeout_ms) {
+        const int ready = milliseconds_until_ready();
+        if (ready < 0) {
+            return poll_input(timeout_ms);
+        }
+
+        // Half a sequence is buffered: wake up for its rest, or when the escape timeout decides it
+        if (timeout_ms >= 0 && timeout_ms < ready) {
+            return poll_input(timeout_ms);
+        }
+        poll_input(ready);
+        return true;
+    }
+
+    void Input::set_escape_timeout(const int timeout_ms) {
+        escape_timeout_ = std::chrono::milliseconds(std::max(0, timeout_ms));
+    }
+
+    bool Input::poll_input(const int timeout_ms) {
 #ifdef _WIN32
         HANDLE hInput = GetStdHandle(STD_INPUT_HANDLE);
         if (hInput == INVALID_HANDLE_VALUE) {
             return false;
         }
-        DWORD result = WaitForSingleObject(hInput, static_cast<DWORD>(timeout_ms));
+        DWORD result = WaitForSingleObject(hInput, timeout_ms < 0 ? INFINITE : static_cast<DWORD>(timeout_ms));
         return result == WAIT_OBJECT_0;
 #else
         fd_set readfds;
@@ -61,51 +157,60 @@ namespace tui {
         timeout.tv_sec = timeout_ms / 1000;
         timeout.tv_usec = (timeout_ms % 1000) * 1000;
 
-        const int result = select(STDIN_FILENO + 1, &readfds, nullptr, nullptr, &timeout);
+        const int result =
+            select(STDIN_FILENO + 1, &readfds, nullptr, nullptr, timeout_ms < 0 ? nullptr : &timeout);
         return result > 0;
 #endif
     }
 
+    std::optional<KeyEvent> Input::read_event() {
+        // Half a sequence in the buffer needs the bytes that came in since
+        if (buffer_.empty() || escape_since_) {
+            fill_buffer();
+        }
+        if (buffer_.empty()) {
+            return std::nullopt;
+        }
+
+#ifdef _WIN32
+        // _getch() reports extended keys as 0 or 224 followed by a scan code
+        if (const int lead = buffer_.peek(); lead == 0 || lead == 224) {
+            buffer_.consume(1);
+            return KeyEvent(map_scan_code(get_key()));
+        }
+#endif
+
+        ParsedKey parsed = parse_key(buffer_);
+
+        // ESC state machine: Escape key or the start of a sequence? Decided by the next
+        // bytes, or by the timeout once none came. The event loop returns here either way.
+        if (parsed.status == ParsedKey::Status::INCOMPLETE) {
+            const auto now = std::chrono::steady_clock::now();
+            if (!escape_since_) {
+                escape_since_ = now;
+            }
+            if (now - *escape_since_ < escape_timeout_) {
+                return std::nullopt;
+            }
+            parsed = parse_key(buffer_, true);
+        }
+        escape_since_.reset();
+
+        buffer_.consume(parsed.length);
+        return parsed.event;
+    }
+
     std::pair<Key, char> Input::get_input() {
-        int ch = get_key();
-        if (ch == 27) { // Escape
-            if (wait_for_input(10)) {
-                const int ch1 = get_key();
-                if (ch1 == 27) {
-                    return {Key::ESCAPE, 0};
-                }
-
-                if (ch1 == '[' || ch1 == 'O') {
-                    switch (get_key()) {
-                    case 'A':
-                        return {Key::ARROW_UP, 0};
-                    case 'B':
-                        return {Key::ARROW_DOWN, 0};
-                    case 'C':
-                        return {Key::ARROW_RIGHT, 0};
-                    case 'D':
-                        return {Key::ARROW_LEFT, 0};
-                    case 'H':
-                        return {Key::HOME, 0};
-                    case 'F':
-                        return {Key::END, 0};
-                    case '5':
-                        get_key();
-                        return {Key::PAGE_UP, 0};
-                    case '6':
-                        get_key();
-                        return {Key::PAGE_DOWN, 0};
-                    case '3':
-                        get_key();
-                        return {Key::KEY_DELETE, 0};
-                    default:
-                        return {Key::UNKNOWN, 0};
-                    }
-                }
+        std::optional<KeyEvent> event;
+        while (!(event = read_event())) {
+            if (!wait_for_input(-1)) {
+                return {Key::UNKNOWN, 0};
             }
-            return {Key::ESCAPE, 0};
         }
+        return {event->key, event->character};
+    }
 
+    std::pair<Key, char> Input::map_character(const int ch) {
         switch (ch) {
         case '\n':
         case '\r':
@@ -117,40 +222,12 @@ namespace tui {
         case 8:
         case 127:
             return {Key::BACKSPACE, 0};
-#ifdef _WIN32
-        case 224:
-            ch = get_key();
-            switch (ch) {
-            case 72:
-                return {Key::ARROW_UP, 0};
-            case 80:
-                return {Key::ARROW_DOWN, 0};
-            case 75:
-                return {Key::ARROW_LEFT, 0};
-            case 77:
-                return {Key::ARROW_RIGHT, 0};
-            case 71:
-                return {Key::HOME, 0};
-            case 79:
-                return {Key::END, 0};
-            case 73:
-                return {Key::PAGE_UP, 0};
-            case 81:
-                return {Key::PAGE_DOWN, 0};
-            case 83:
-                return {Key::KEY_DELETE, 0};
-            default:
-                return {Key::UNKNOWN, 0};
-            }
-#endif
+        case 27:
+            return {Key::ESCAPE, 0};
         default:
             return {(ch >= 32 && ch <= 126) ? Key::NORMAL : Key::UNKNOWN,
                     (ch >= 32 && ch <= 126) ? static_cast<char>(ch) : 0};
         }
     }
 
-    Key Input::parse_escape_sequence() {
-        return Key::UNKNOWN;
-    }
-
 } // namespace tui
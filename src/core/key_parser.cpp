@@ -0,0 +1,261 @@
+#include "core/key_parser.hpp"
+#include <array>
+#include <cstdint>
+
+namespace tui {
+
+    namespace {
+        constexpr int ESC = 27;
+        constexpr size_t MAX_SEQUENCE_LENGTH = 64; ///< Longer CSI sequences are dropped as garbage
+
+        // Final byte of CSI / SS3 sequences without a numeric key code: ESC [ A, ESC O P, ESC [ 1 ; 5 A
+        constexpr std::array<Key, 128> make_final_keys() {
+            std::array<Key, 128> keys{};
+            keys['A'] = Key::ARROW_UP;
+            keys['B'] = Key::ARROW_DOWN;
+            keys['C'] = Key::ARROW_RIGHT;
+            keys['D'] = Key::ARROW_LEFT;
+            keys['H'] = Key::HOME;
+            keys['F'] = Key::END;
+            keys['P'] = Key::F1;
+            keys['Q'] = Key::F2;
+            keys['R'] = Key::F3;
+            keys['S'] = Key::F4;
+            keys['Z'] = Key::TAB; // Back tab, reported with Shift
+            return keys;
+        }
+
+        // Key code of "CSI code ~" sequences (vt220 style, used by xterm, rxvt, linux console)
+        constexpr std::array<Key, 35> make_tilde_keys() {
+            std::array<Key, 35> keys{};
+            keys[1] = Key::HOME;
+            keys[2] = Key::INSERT;
+            keys[3] = Key::KEY_DELETE;
+            keys[4] = Key::END;
+            keys[5] = Key::PAGE_UP;
+            keys[6] = Key::PAGE_DOWN;
+            keys[7] = Key::HOME;
+            keys[8] = Key::END;
+            keys[11] = Key::F1;
+            keys[12] = Key::F2;
+            keys[13] = Key::F3;
+            keys[14] = Key::F4;
+            keys[15] = Key::F5;
+            keys[17] = Key::F6;
+            keys[18] = Key::F7;
+            keys[19] = Key::F8;
+            keys[20] = Key::F9;
+            keys[21] = Key::F10;
+            keys[23] = Key::F11;
+            keys[24] = Key::F12;
+            return keys;
+        }
+
+        // Final byte after "ESC [ [" on the Linux console, A is F1
+        constexpr std::array<Key, 5> LINUX_CONSOLE_KEYS = {Key::F1, Key::F2, Key::F3, Key::F4, Key::F5};
+
+        constexpr auto FINAL_KEYS = make_final_keys();
+        constexpr auto TILDE_KEYS = make_tilde_keys();
+
+        static_assert(FINAL_KEYS['B'] == Key::ARROW_DOWN);
+        static_assert(TILDE_KEYS[24] == Key::F12);
+
+        /**
+         * @brief Parameters of a CSI sequence, only the parts keys use
+         *
+         * "CSI 1 ; 5 A" has code 1 and modifier 5, kitty's "CSI 97 : 65 ; 2 u" also
+         * has the shifted code 65 as the first sub-parameter.
+         */
+        struct CsiParameters {
+            uint32_t code = 0;
+            uint32_t shifted_code = 0;
+            uint32_t modifier = 1;
+            bool valid = true;
+        };
+
+        CsiParameters parse_parameters(const InputBuffer& buffer, size_t from, const size_t to) {
+            CsiParameters parameters;
+            if (from < to && buffer.peek(from) >= '<' && buffer.peek(from) <= '?') {
+                parameters.valid = false; // Private marker, a report rather than a key
+                return parameters;
+            }
+
+            size_t field = 0;
+            size_t sub_field = 0;
+            uint32_t value = 0;
+            bool has_value = false;
+
+            const auto store = [&] {
+                if (!has_value) {
+                    return;
+                }
+                if (field == 0 && sub_field == 0) {
+                    parameters.code = value;
+                } else if (field == 0 && sub_field == 1) {
+                    parameters.shifted_code = value;
+                } else if (field == 1 && sub_field == 0) {
+                    parameters.modifier = value;
+                }
+            };
+
+            for (; from < to; ++from) {
+                const int byte = buffer.peek(from);
+                if (byte >= '0' && byte <= '9') {
+                    value = value < 100000 ? value * 10 + static_cast<uint32_t>(byte - '0') : value;
+                    has_value = true;
+                    continue;
+                }
+
+                store();
+                value = 0;
+                has_value = false;
+                if (byte == ';') {
+                    ++field;
+                    sub_field = 0;
+                } else if (byte == ':') {
+                    ++sub_field;
+                } else {
+                    parameters.valid = false;
+                    return parameters;
+                }
+            }
+            store();
+            return parameters;
+        }
+
+        // xterm and kitty encode modifiers as 1 + bit mask (1 Shift, 2 Alt, 4 Ctrl)
+        uint8_t decode_modifiers(const uint32_t parameter) {
+            const uint32_t mask = parameter > 0 ? parameter - 1 : 0;
+            return static_cast<uint8_t>(mask & (static_cast<uint32_t>(KeyModifier::SHIFT) |
+                                                static_cast<uint32_t>(KeyModifier::ALT) |
+                                                static_cast<uint32_t>(KeyModifier::CTRL)));
+        }
+
+        KeyEvent kitty_key(const CsiParameters& parameters, const uint8_t modifiers) {
+            uint32_t code = parameters.code;
+            if ((modifiers & static_cast<uint8_t>(KeyModifier::SHIFT)) && parameters.shifted_code != 0) {
+                code = parameters.shifted_code;
+            }
+
+            // Functional keys in the private use area (keypad, media, lone modifiers) have no Key
+            if (code > 126) {
+                return KeyEvent(code == 127 ? Key::BACKSPACE : Key::UNKNOWN, '\0', modifiers);
+            }
+
+            auto [key, character] = Input::map_character(static_cast<int>(code));
+            return KeyEvent(key, character, modifiers);
+        }
+
+        ParsedKey make(const KeyEvent event, const size_t length) { return {ParsedKey::Status::KEY, event, length}; }
+
+        ParsedKey incomplete() { return {ParsedKey::Status::INCOMPLETE, KeyEvent(), 0}; }
+
+        ParsedKey parse_at(const InputBuffer& buffer, const size_t start, const bool flush) {
+            const int lead = buffer.peek(start);
+            if (lead != ESC) {
+                auto [key, character] = Input::map_character(lead);
+                return make(KeyEvent(key, character), 1);
+            }
+
+            const int introducer = buffer.peek(start + 1);
+            if (introducer == EOF) {
+                return flush ? make(KeyEvent(Key::ESCAPE), 1) : incomplete();
+            }
+
+            if (introducer == 'O') {
+                // SS3: exactly one final byte
+                const int final = buffer.peek(start + 2);
+                if (final == EOF) {
+                    return flush ? make(KeyEvent(Key::ESCAPE), 1) : incomplete();
+                }
+                const Key key = final < 128 ? FINAL_KEYS[static_cast<size_t>(final)] : Key::UNKNOWN;
+                return make(KeyEvent(key), 3);
+            }
+
+            // Linux console F1-F5: ESC [ [ A .. ESC [ [ E
+            if (introducer == '[' && buffer.peek(start + 2) == '[') {
+                const int final = buffer.peek(start + 3);
+                if (final == EOF) {
+                    return flush ? make(KeyEvent(Key::ESCAPE), 1) : incomplete();
+                }
+                const Key key = final >= 'A' && final <= 'E' ? LINUX_CONSOLE_KEYS[static_cast<size_t>(final - 'A')]
+                                                             : Key::UNKNOWN;
+                return make(KeyEvent(key), 4);
+            }
+
+            if (introducer == '[') {
+                // CSI: parameter bytes 0x30-0x3F, intermediate bytes 0x20-0x2F, one final byte 0x40-0x7E
+                size_t position = start + 2;
+                int byte = buffer.peek(position);
+                while (byte >= 0x30 && byte <= 0x3F && position - start < MAX_SEQUENCE_LENGTH) {
+                    byte = buffer.peek(++position);
+                }
+                const size_t parameters_end = position;
+                while (byte >= 0x20 && byte <= 0x2F && position - start < MAX_SEQUENCE_LENGTH) {
+                    byte = buffer.peek(++position);
+                }
+
+                if (byte == EOF) {
+                    return flush ? make(KeyEvent(Key::ESCAPE), 1) : incomplete();
+                }
+                if (byte < 0x40 || byte > 0x7E) {
+                    // Malformed, drop what was read and resync on the offending byte
+                    return make(KeyEvent(), position - start);
+                }
+
+                const size_t length = position + 1 - start;
+                const CsiParameters parameters = parse_parameters(buffer, start + 2, parameters_end);
+                if (!parameters.valid || parameters_end != position) {
+                    return make(KeyEvent(), length);
+                }
+
+                uint8_t modifiers = decode_modifiers(parameters.modifier);
+                switch (byte) {
+                case '~': {
+                    const Key key = parameters.code < TILDE_KEYS.size() ? TILDE_KEYS[parameters.code] : Key::UNKNOWN;
+                    return make(KeyEvent(key, '\0', modifiers), length);
+                }
+                case 'u':
+                    return make(kitty_key(parameters, modifiers), length);
+                case 'Z':
+                    modifiers |= static_cast<uint8_t>(KeyModifier::SHIFT);
+                    [[fallthrough]];
+                default:
+                    return make(KeyEvent(FINAL_KEYS[static_cast<size_t>(byte)], '\0', modifiers), length);
+                }
+            }
+
+            // Alt+key arrives as ESC followed by the key, Alt+arrow on some terminals as ESC ESC [ A
+            if (introducer == ESC) {
+                const int next = buffer.peek(start + 2);
+                if (next == EOF && !flush) {
+                    return incomplete();
+                }
+                if (next == '[' || next == 'O') {
+                    ParsedKey inner = parse_at(buffer, start + 1, flush);
+                    if (inner.status == ParsedKey::Status::INCOMPLETE) {
+                        return inner;
+                    }
+                    if (inner.length > 1) {
+                        inner.event.modifiers |= static_cast<uint8_t>(KeyModifier::ALT);
+                        inner.length += 1;
+                        return inner;
+                    }
+                }
+                // Two Escape presses, the second ESC is decoded on its own
+                return make(KeyEvent(Key::ESCAPE), 1);
+            }
+
+            auto [key, character] = Input::map_character(introducer);
+            return make(KeyEvent(key, character, static_cast<uint8_t>(KeyModifier::ALT)), 2);
+        }
+    } // namespace
+
+    ParsedKey parse_key(const InputBuffer& buffer, const bool flush) {
+        if (buffer.empty()) {
+            return incomplete();
+        }
+        return parse_at(buffer, 0, flush);
+    }
+
+} // namespace tui
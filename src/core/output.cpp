@@ -0,0 +1,19 @@
+#include "core/output.hpp"
+#include "core/backend.hpp"
+
+namespace tui {
+
+    size_t OutputBuffer::flush(TerminalBackend& backend) {
+        if (buffer_.empty()) {
+            return 0;
+        }
+
+        const size_t written = backend.write(buffer_);
+        ++total_writes_;
+
+        total_bytes_ += written;
+        buffer_.clear();
+        return written;
+    }
+
+} // namespace tui
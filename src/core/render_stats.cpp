@@ -0,0 +1,87 @@
+#include "core/render_stats.hpp"
+#include <algorithm>
+
+namespace tui {
+
+    namespace {
+        RenderStats::Distribution distribution(std::vector<std::chrono::nanoseconds>& samples) {
+            RenderStats::Distribution result;
+            if (samples.empty()) {
+                return result;
+            }
+
+            const auto at = [&samples](const size_t percent) {
+                const size_t rank = std::min(samples.size() - 1, samples.size() * percent / 100);
+                std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(rank), samples.end());
+                return samples[rank];
+            };
+
+            result.p50 = at(50);
+            result.p99 = at(99);
+            result.max = *std::max_element(samples.begin(), samples.end());
+            return result;
+        }
+    } // namespace
+
+    void RenderStatsCollector::record(FrameStats& frame) {
+        frame.frame = ++frames_;
+        full_frames_ += frame.full_frame ? 1 : 0;
+        total_bytes_ += frame.bytes;
+        total_writes_ += frame.writes;
+
+        if (window_.size() < WINDOW) {
+            window_.push_back(frame);
+        } else {
+            window_[next_] = frame;
+        }
+        next_ = (next_ + 1) % WINDOW;
+    }
+
+    RenderStats RenderStatsCollector::snapshot() const {
+        RenderStats stats;
+        stats.frames = frames_;
+        stats.skipped_frames = skipped_frames_;
+        stats.full_frames = full_frames_;
+        stats.total_bytes = total_bytes_;
+        stats.total_writes = total_writes_;
+
+        if (window_.empty()) {
+            return stats;
+        }
+
+        std::vector<std::chrono::nanoseconds> samples;
+        samples.reserve(window_.size());
+
+        const auto phase = [&](std::chrono::nanoseconds FrameStats::*member) {
+            samples.clear();
+            for (const auto& frame : window_) {
+                samples.push_back(frame.*member);
+            }
+            return distribution(samples);
+        };
+
+        stats.frame_time = phase(&FrameStats::total);
+        stats.layout = phase(&FrameStats::layout);
+        stats.format = phase(&FrameStats::format);
+        stats.emit = phase(&FrameStats::emit);
+        stats.flush = phase(&FrameStats::flush);
+
+        samples.clear();
+        size_t bytes = 0;
+        size_t writes = 0;
+        for (const auto& frame : window_) {
+            if (frame.input_latency) {
+                samples.push_back(*frame.input_latency);
+            }
+            bytes += frame.bytes;
+            writes += frame.writes;
+        }
+        stats.input_latency = distribution(samples);
+        stats.bytes_per_frame = static_cast<double>(bytes) / static_cast<double>(window_.size());
+        stats.writes_per_frame = static_cast<double>(writes) / static_cast<double>(window_.size());
+        return stats;
+    }
+
+    void RenderStatsCollector::reset() { *this = RenderStatsCollector{}; }
+
+} // namespace tui
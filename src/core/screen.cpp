@@ -0,0 +1,191 @@
+#include "core/screen.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include "core/terminal.hpp"
+#include "core/unicode.hpp"
+
+namespace tui {
+
+    void ScreenBuffer::resize(const int rows, const int cols) {
+        if (rows == rows_ && cols == cols_) {
+            return;
+        }
+
+        rows_ = std::max(0, rows);
+        cols_ = std::max(0, cols);
+        back_.assign(static_cast<size_t>(rows_) * static_cast<size_t>(cols_), Cell{});
+        front_.assign(back_.size(), Cell{});
+        front_valid_ = false;
+    }
+
+    void ScreenBuffer::clear() { std::fill(back_.begin(), back_.end(), Cell{}); }
+
+    void ScreenBuffer::clear_line(const int row) {
+        if (row < 1 || row > rows_) {
+            return;
+        }
+        std::fill_n(back_.begin() + static_cast<std::ptrdiff_t>(index(row, 1)), cols_, Cell{});
+    }
+
+    void ScreenBuffer::put(const int row, const int col, const std::string_view glyph, const CellStyle& style,
+                           const int width) {
+        const size_t i = index(row, col);
+
+        // Overwriting the right half of a wide glyph leaves its left half alone on screen
+        if (back_[i].glyph.empty() && col > 1) {
+            back_[i - 1].glyph = " ";
+        }
+
+        back_[i].glyph.assign(glyph.data(), glyph.size());
+        back_[i].style = style;
+
+        const int next = col + width;
+        if (width == 2) {
+            back_[i + 1].glyph.clear();
+            back_[i + 1].style = style;
+        }
+
+        // ...and overwriting the left half orphans the right one
+        if (next <= cols_ && back_[index(row, next)].glyph.empty()) {
+            back_[index(row, next)].glyph = " ";
+        }
+    }
+
+    int ScreenBuffer::draw_text(const int row, int col, const std::string_view text, const CellStyle& style) {
+        if (row < 1 || row > rows_) {
+            return col;
+        }
+
+        CellStyle current = style;
+        for (size_t i = 0; i < text.size() && col <= cols_;) {
+            const auto c = static_cast<unsigned char>(text[i]);
+
+            if (c == '\033') {
+                // CSI: parameters up to the final byte (0x40-0x7E)
+                if (i + 1 < text.size() && text[i + 1] == '[') {
+                    size_t end = i + 2;
+                    while (end < text.size() && (text[end] < 0x40 || text[end] > 0x7E)) {
+                        ++end;
+                    }
+                    if (end < text.size() && text[end] == 'm') {
+                        apply_sgr(text.substr(i + 2, end - i - 2), current);
+                    }
+                    i = end + 1;
+                } else {
+                    i += 2;
+                }
+                continue;
+            }
+
+            if (c < 0x20 || c == 0x7F) {
+                ++i;
+                continue;
+            }
+
+            size_t next = i;
+            const int width = unicode::code_point_width(unicode::decode_utf8(text, next));
+            const std::string_view glyph = text.substr(i, next - i);
+            i = next;
+
+            if (width == 0) {
+                // Combining marks and joiners belong to the glyph before them
+                if (int target = col - 1; target >= 1 && target <= cols_) {
+                    if (back_[index(row, target)].glyph.empty() && target > 1) {
+                        --target;
+                    }
+                    back_[index(row, target)].glyph.append(glyph.data(), glyph.size());
+                }
+                continue;
+            }
+
+            if (col >= 1) {
+                if (width == 2 && col == cols_) {
+                    // Half a wide glyph does not fit at the edge
+                    put(row, col, " ", current, 1);
+                } else {
+                    put(row, col, glyph, current, width);
+                }
+            }
+            col += width;
+        }
+
+        return col;
+    }
+
+    const Cell& ScreenBuffer::at(const int row, const int col) const { return back_[index(row, col)]; }
+
+    void ScreenBuffer::scroll(const int top, const int bottom, const int lines) {
+        if (!front_valid_ || lines == 0 || top < 1 || bottom > rows_ || top >= bottom ||
+            std::abs(lines) > bottom - top) {
+            return;
+        }
+
+        // Lines scrolled in take the current background color
+        TerminalUtils::apply_style(CellStyle{});
+
+        OutputBuffer& out = TerminalUtils::output();
+        out.format("\033[{};{}r", top, bottom);
+        if (lines > 0) {
+            out.format("\033[{}S", lines);
+        } else {
+            out.format("\033[{}T", -lines);
+        }
+        // Resetting the margins also homes the cursor
+        out.append("\033[r");
+        TerminalUtils::forget_cursor_position();
+
+        const auto row_begin = [this](const int row) {
+            return front_.begin() + static_cast<std::ptrdiff_t>(index(row, 1));
+        };
+
+        if (lines > 0) {
+            std::move(row_begin(top + lines), row_begin(bottom + 1), row_begin(top));
+            std::fill(row_begin(bottom - lines + 1), row_begin(bottom + 1), Cell{});
+        } else {
+            std::move_backward(row_begin(top), row_begin(bottom + lines + 1), row_begin(bottom + 1));
+            std::fill(row_begin(top), row_begin(top - lines), Cell{});
+        }
+    }
+
+    void ScreenBuffer::flush() {
+        OutputBuffer& out = TerminalUtils::output();
+
+        if (!front_valid_) {
+            TerminalUtils::forget_style();
+            TerminalUtils::apply_style(CellStyle{});
+            out.append("\033[2J");
+            std::fill(front_.begin(), front_.end(), Cell{});
+            front_valid_ = true;
+            // Whatever invalidated the screen may have moved the cursor too
+            TerminalUtils::forget_cursor_position();
+        }
+
+
+        for (int row = 1; row <= rows_; ++row) {
+            for (int col = 1; col <= cols_; ++col) {
+                const size_t i = index(row, col);
+                const Cell& cell = back_[i];
+                if (cell == front_[i]) {
+                    continue;
+                }
+
+                if (cell.glyph.empty()) {
+                    // Right half of a wide glyph, the terminal fills it together with the left half
+                    front_[i] = cell;
+                    continue;
+                }
+
+                TerminalUtils::append_cursor_move(row, col);
+                TerminalUtils::apply_style(cell.style);
+
+                out.append(cell.glyph);
+                front_[i] = cell;
+                TerminalUtils::advance_cursor((col < cols_ && back_[i + 1].glyph.empty()) ? 2 : 1);
+            }
+        }
+
+        // Leave the default style behind for anything printed between frames
+        TerminalUtils::apply_style(CellStyle{});
+    }
+
+} // namespace tui
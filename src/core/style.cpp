@@ -0,0 +1,367 @@
+#include "core/style.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace tui {
+
+    namespace {
+        CellColor ansi_color(const int code) {
+            CellColor color;
+            color.type = CellColor::Type::ANSI;
+            color.code = static_cast<uint8_t>(code);
+            return color;
+        }
+
+        // Parses the extended color forms "5;n" and "2;r;g;b" starting at params[i]
+        CellColor extended_color(const std::vector<int>& params, size_t& i) {
+            CellColor color;
+            if (i + 1 < params.size() && params[i + 1] == 5 && i + 2 < params.size()) {
+                color.type = CellColor::Type::INDEXED;
+                color.code = static_cast<uint8_t>(params[i + 2]);
+                i += 2;
+            } else if (i + 1 < params.size() && params[i + 1] == 2 && i + 4 < params.size()) {
+                color.type = CellColor::Type::RGB;
+                color.r = static_cast<uint8_t>(params[i + 2]);
+                color.g = static_cast<uint8_t>(params[i + 3]);
+                color.b = static_cast<uint8_t>(params[i + 4]);
+                i += 4;
+            }
+            return color;
+        }
+
+        constexpr std::pair<uint8_t, int> ATTRIBUTE_CODES[] = {
+            {CellStyle::BOLD, 1},  {CellStyle::DIM, 2},     {CellStyle::ITALIC, 3},       {CellStyle::UNDERLINE, 4},
+            {CellStyle::BLINK, 5}, {CellStyle::REVERSE, 7}, {CellStyle::STRIKETHROUGH, 9}};
+
+        // 22 switches bold and dim off together
+        constexpr std::pair<uint8_t, int> ATTRIBUTE_OFF_CODES[] = {
+            {CellStyle::BOLD | CellStyle::DIM, 22}, {CellStyle::ITALIC, 23},  {CellStyle::UNDERLINE, 24},
+            {CellStyle::BLINK, 25},                 {CellStyle::REVERSE, 27}, {CellStyle::STRIKETHROUGH, 29}};
+
+        void add_param(fmt::memory_buffer& params, const int code) {
+            if (params.size() > 0) {
+                params.push_back(';');
+            }
+            fmt::format_to(fmt::appender(params), "{}", code);
+        }
+
+        void add_color(fmt::memory_buffer& params, const CellColor& color, const bool background) {
+            switch (color.type) {
+            case CellColor::Type::ANSI:
+                add_param(params, color.code);
+                break;
+            case CellColor::Type::INDEXED:
+                add_param(params, background ? 48 : 38);
+                fmt::format_to(fmt::appender(params), ";5;{}", color.code);
+                break;
+            case CellColor::Type::RGB:
+                add_param(params, background ? 48 : 38);
+                fmt::format_to(fmt::appender(params), ";2;{};{};{}", color.r, color.g, color.b);
+                break;
+            case CellColor::Type::DEFAULT:
+            default:
+                add_param(params, background ? 49 : 39);
+                break;
+            }
+        }
+
+        struct Rgb {
+            int r, g, b;
+        };
+
+        // xterm defaults for the 16 classic colors
+        constexpr Rgb ANSI_PALETTE[16] = {
+            {0, 0, 0},       {205, 0, 0},     {0, 205, 0},     {205, 205, 0},   {0, 0, 238},     {205, 0, 205},
+            {0, 205, 205},   {229, 229, 229}, {127, 127, 127}, {255, 0, 0},     {0, 255, 0},     {255, 255, 0},
+            {92, 92, 255},   {255, 0, 255},   {0, 255, 255},   {255, 255, 255}};
+
+        constexpr int CUBE_LEVELS[6] = {0, 95, 135, 175, 215, 255};
+
+        Rgb palette_color(const int index) {
+            if (index < 16) {
+                return ANSI_PALETTE[index];
+            }
+            if (index < 232) {
+                const int cube = index - 16;
+                return {CUBE_LEVELS[cube / 36], CUBE_LEVELS[cube / 6 % 6], CUBE_LEVELS[cube % 6]};
+            }
+            const int gray = 8 + 10 * (index - 232);
+            return {gray, gray, gray};
+        }
+
+        // Squared distance weighted for the eye's sensitivity to green
+        int distance(const Rgb& a, const Rgb& b) {
+            const int dr = a.r - b.r;
+            const int dg = a.g - b.g;
+            const int db = a.b - b.b;
+            return 2 * dr * dr + 4 * dg * dg + 3 * db * db;
+        }
+
+        int nearest_cube_level(const int value) {
+            int best = 0;
+            for (int i = 1; i < 6; ++i) {
+                if (std::abs(CUBE_LEVELS[i] - value) < std::abs(CUBE_LEVELS[best] - value)) {
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        // Nearest entry of the 6x6x6 cube or the gray ramp; the first 16 entries vary between terminals
+        uint8_t nearest_256(const Rgb& color) {
+            const int r = nearest_cube_level(color.r);
+            const int g = nearest_cube_level(color.g);
+            const int b = nearest_cube_level(color.b);
+            const int cube = 16 + 36 * r + 6 * g + b;
+
+            const int average = (color.r + color.g + color.b) / 3;
+            const int gray = 232 + std::clamp((average - 3) / 10, 0, 23);
+
+            return static_cast<uint8_t>(distance(color, palette_color(gray)) < distance(color, palette_color(cube))
+                                            ? gray
+                                            : cube);
+        }
+
+        uint8_t nearest_16(const Rgb& color) {
+            int best = 0;
+            for (int i = 1; i < 16; ++i) {
+                if (distance(color, ANSI_PALETTE[i]) < distance(color, ANSI_PALETTE[best])) {
+                    best = i;
+                }
+            }
+            return static_cast<uint8_t>(best);
+        }
+
+        /**
+         * @brief Nearest palette entries for every color at 5 bits per channel
+         */
+        struct QuantizationTables {
+            static constexpr size_t SIZE = 1 << 15;
+
+            std::array<uint8_t, SIZE> to_256{};
+            std::array<uint8_t, SIZE> to_16{};
+
+            QuantizationTables() {
+                for (size_t key = 0; key < SIZE; ++key) {
+                    // Center of the bucket
+                    const Rgb color{static_cast<int>((key >> 10) << 3 | 4), static_cast<int>((key >> 5 & 31) << 3 | 4),
+                                    static_cast<int>((key & 31) << 3 | 4)};
+                    to_256[key] = nearest_256(color);
+                    to_16[key] = nearest_16(color);
+                }
+            }
+
+            static size_t key(const int r, const int g, const int b) {
+                return static_cast<size_t>(r >> 3) << 10 | static_cast<size_t>(g >> 3) << 5 |
+                    static_cast<size_t>(b >> 3);
+            }
+        };
+
+        const QuantizationTables& quantization_tables() {
+            static const QuantizationTables tables;
+            return tables;
+        }
+
+        CellColor ansi_from_palette(const uint8_t index, const bool background) {
+            return ansi_color((index < 8 ? 30 + index : 82 + index) + (background ? 10 : 0));
+        }
+    } // namespace
+
+    CellColor downsample(const CellColor& color, const ColorDepth depth, const bool background) {
+        if (depth == ColorDepth::TRUECOLOR || color.type == CellColor::Type::DEFAULT ||
+            color.type == CellColor::Type::ANSI) {
+            return color;
+        }
+
+        if (color.type == CellColor::Type::INDEXED) {
+            if (depth == ColorDepth::INDEXED256) {
+                return color;
+            }
+            if (color.code < 16) {
+                return ansi_from_palette(color.code, background);
+            }
+            const Rgb rgb = palette_color(color.code);
+            return ansi_from_palette(quantization_tables().to_16[QuantizationTables::key(rgb.r, rgb.g, rgb.b)],
+                                     background);
+        }
+
+        const auto& tables = quantization_tables();
+        const size_t key = QuantizationTables::key(color.r, color.g, color.b);
+        if (depth == ColorDepth::ANSI16) {
+            return ansi_from_palette(tables.to_16[key], background);
+        }
+
+        CellColor indexed;
+        indexed.type = CellColor::Type::INDEXED;
+        indexed.code = tables.to_256[key];
+        return indexed;
+    }
+
+    CellStyle downsample(const CellStyle& style, const ColorDepth depth) {
+        if (depth == ColorDepth::TRUECOLOR) {
+            return style;
+        }
+
+        CellStyle result = style;
+        result.fg = downsample(style.fg, depth, false);
+        result.bg = downsample(style.bg, depth, true);
+        return result;
+    }
+
+    CellStyle CellStyle::from_color(const extras::Color& color) {
+        CellStyle style;
+        if (color.type == extras::Color::Type::RGB) {
+            style.fg.type = CellColor::Type::RGB;
+            style.fg.r = color.r;
+            style.fg.g = color.g;
+            style.fg.b = color.b;
+        } else if (color.ansi_color != extras::AccentColor::RESET) {
+            style.fg.type = CellColor::Type::ANSI;
+            style.fg.code = static_cast<uint8_t>(color.ansi_color);
+        }
+        return style;
+    }
+
+    CellStyle CellStyle::from_rgb(const uint8_t r, const uint8_t g, const uint8_t b) {
+        CellStyle style;
+        style.fg.type = CellColor::Type::RGB;
+        style.fg.r = r;
+        style.fg.g = g;
+        style.fg.b = b;
+        return style;
+    }
+
+    void SgrState::transition(OutputBuffer& out, const CellStyle& style) {
+        if (known_ && style == current_) {
+            return;
+        }
+
+        // Starting over from a reset...
+        fmt::memory_buffer reset;
+        add_param(reset, 0);
+        for (const auto& [attribute, code] : ATTRIBUTE_CODES) {
+            if (style.attributes & attribute) {
+                add_param(reset, code);
+            }
+        }
+        if (style.fg.type != CellColor::Type::DEFAULT) {
+            add_color(reset, style.fg, false);
+        }
+        if (style.bg.type != CellColor::Type::DEFAULT) {
+            add_color(reset, style.bg, true);
+        }
+
+        // ...or changing only what differs
+        fmt::memory_buffer delta;
+        if (known_) {
+            uint8_t kept = current_.attributes;
+            for (const auto& [mask, code] : ATTRIBUTE_OFF_CODES) {
+                if (current_.attributes & mask & ~style.attributes) {
+                    add_param(delta, code);
+                    kept &= static_cast<uint8_t>(~mask);
+                }
+            }
+            for (const auto& [attribute, code] : ATTRIBUTE_CODES) {
+                if ((style.attributes & attribute) && !(kept & attribute)) {
+                    add_param(delta, code);
+                }
+            }
+            if (style.fg != current_.fg) {
+                add_color(delta, style.fg, false);
+            }
+            if (style.bg != current_.bg) {
+                add_color(delta, style.bg, true);
+            }
+        }
+
+        const fmt::memory_buffer& params = (known_ && delta.size() < reset.size()) ? delta : reset;
+        out.append("\033[");
+        out.append(std::string_view(params.data(), params.size()));
+        out.append('m');
+
+        current_ = style;
+        known_ = true;
+    }
+
+    void apply_sgr(const std::string_view parameters, CellStyle& style) {
+        std::vector<int> params{0};
+        for (const char c : parameters) {
+            if (c == ';') {
+                params.push_back(0);
+            } else if (c >= '0' && c <= '9') {
+                params.back() = params.back() * 10 + (c - '0');
+            }
+        }
+
+        for (size_t i = 0; i < params.size(); ++i) {
+            switch (const int p = params[i]; p) {
+            case 0:
+                style = CellStyle{};
+                break;
+            case 1:
+                style.attributes |= CellStyle::BOLD;
+                break;
+            case 2:
+                style.attributes |= CellStyle::DIM;
+                break;
+            case 3:
+                style.attributes |= CellStyle::ITALIC;
+                break;
+            case 4:
+                style.attributes |= CellStyle::UNDERLINE;
+                break;
+            case 5:
+            case 6:
+                style.attributes |= CellStyle::BLINK;
+                break;
+            case 7:
+                style.attributes |= CellStyle::REVERSE;
+                break;
+            case 9:
+                style.attributes |= CellStyle::STRIKETHROUGH;
+                break;
+            case 22:
+                style.attributes &= ~(CellStyle::BOLD | CellStyle::DIM);
+                break;
+            case 23:
+                style.attributes &= ~CellStyle::ITALIC;
+                break;
+            case 24:
+                style.attributes &= ~CellStyle::UNDERLINE;
+                break;
+            case 25:
+                style.attributes &= ~CellStyle::BLINK;
+                break;
+            case 27:
+                style.attributes &= ~CellStyle::REVERSE;
+                break;
+            case 29:
+                style.attributes &= ~CellStyle::STRIKETHROUGH;
+                break;
+            case 38:
+                style.fg = extended_color(params, i);
+                break;
+            case 39:
+                style.fg = CellColor{};
+                break;
+            case 48:
+                style.bg = extended_color(params, i);
+                break;
+            case 49:
+                style.bg = CellColor{};
+                break;
+            default:
+                if ((p >= 30 && p <= 37) || (p >= 90 && p <= 97)) {
+                    style.fg = ansi_color(p);
+                } else if ((p >= 40 && p <= 47) || (p >= 100 && p <= 107)) {
+                    style.bg = ansi_color(p);
+                }
+                break;
+            }
+        }
+    }
+
+} // namespace tui
@@ -2,16 +2,225 @@
 // #include <print>
 #include <fmt/base.h>
 #include "core/input.hpp"
+#include "core/unicode.hpp"
 
 #ifndef _WIN32
+#include <poll.h>
 #include <sys/ioctl.h>
 #endif
 
 #include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string_view>
+#include <vector>
 
 namespace tui {
 
-// Static member definitions
+    namespace {
+        int decimal_digits(int n) {
+            int digits = 1;
+            while (n >= 10) {
+                n /= 10;
+                ++digits;
+            }
+            return digits;
+        }
+
+        // ESC [ n X, the count is left out when it is 1
+        int csi_move_cost(const int n) { return n == 1 ? 3 : 3 + decimal_digits(n); }
+
+        void append_csi_move(OutputBuffer& out, const int n, const char final) {
+            if (n == 1) {
+                out.append("\033[");
+                out.append(final);
+            } else {
+                out.format("\033[{}{}", n, final);
+            }
+        }
+
+        // CUU / CUD
+        int vertical_cost(const int from, const int to) { return from == to ? 0 : csi_move_cost(std::abs(to - from)); }
+
+        void append_vertical(OutputBuffer& out, const int from, const int to) {
+            if (to != from) {
+                append_csi_move(out, std::abs(to - from), to > from ? 'B' : 'A');
+            }
+        }
+
+        // CUF, or backspaces / CUB to the left
+        int horizontal_cost(const int from, const int to) {
+            if (to >= from) {
+                return to == from ? 0 : csi_move_cost(to - from);
+            }
+            return std::min(from - to, csi_move_cost(from - to));
+        }
+
+        void append_horizontal(OutputBuffer& out, const int from, const int to) {
+            if (to > from) {
+                append_csi_move(out, to - from, 'C');
+            } else if (to < from) {
+                if (from - to <= csi_move_cost(from - to)) {
+                    out.append(std::string(static_cast<size_t>(from - to), '\b'));
+                } else {
+                    append_csi_move(out, from - to, 'D');
+                }
+            }
+        }
+
+        // Line feeds only go down; the target row is on screen, so they never scroll
+        int newline_cost(const int from, const int to) {
+            return to > from ? std::min(to - from, csi_move_cost(to - from)) : vertical_cost(from, to);
+        }
+
+        void append_newlines(OutputBuffer& out, const int from, const int to) {
+            if (to > from && to - from <= csi_move_cost(to - from)) {
+                out.append(std::string(static_cast<size_t>(to - from), '\n'));
+            } else {
+                append_vertical(out, from, to);
+            }
+        }
+
+#ifndef _WIN32
+        // Little-endian 16 or 32 bit integer from a compiled terminfo entry
+        int read_terminfo_number(const std::string& data, const size_t offset, const size_t size) {
+            if (offset + size > data.size()) {
+                return -1;
+            }
+
+            uint32_t value = 0;
+            for (size_t i = size; i-- > 0;) {
+                value = value << 8 | static_cast<unsigned char>(data[offset + i]);
+            }
+            // Negative values mean absent or cancelled
+            if (size == 2) {
+                return value >= 0x8000 ? -1 : static_cast<int>(value);
+            }
+            return value >= 0x80000000u ? -1 : static_cast<int>(value);
+        }
+
+        /**
+         * @brief The "colors" capability of the compiled terminfo entry for term, -1 if there is none
+         */
+        int terminfo_colors(const std::string& term) {
+            if (term.empty() || term.find('/') != std::string::npos) {
+                return -1;
+            }
+
+            std::vector<std::string> directories;
+            if (const char* terminfo = std::getenv("TERMINFO")) {
+                directories.emplace_back(terminfo);
+            }
+            if (const char* home = std::getenv("HOME")) {
+                directories.push_back(std::string(home) + "/.terminfo");
+            }
+            if (const char* dirs = std::getenv("TERMINFO_DIRS")) {
+                std::string_view list(dirs);
+                while (!list.empty()) {
+                    const size_t colon = list.find(':');
+                    if (const auto dir = list.substr(0, colon); !dir.empty()) {
+                        directories.emplace_back(dir);
+                    }
+                    list = colon == std::string_view::npos ? std::string_view{} : list.substr(colon + 1);
+                }
+            }
+            for (const char* dir : {"/etc/terminfo", "/lib/terminfo", "/usr/share/terminfo", "/usr/lib/terminfo"}) {
+                directories.emplace_back(dir);
+            }
+
+            constexpr size_t COLORS_INDEX = 13; ///< Position of "colors" among the numeric capabilities
+
+            for (const auto& directory : directories) {
+                // Entries live under their first letter, or its hex code on case-insensitive file systems
+                for (const auto& subdirectory : {std::string(1, term[0]), fmt::format("{:02x}", term[0])}) {
+                    std::ifstream file(directory + "/" + subdirectory + "/" + term, std::ios::binary);
+                    if (!file) {
+                        continue;
+                    }
+
+                    const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                    const int magic = read_terminfo_number(data, 0, 2);
+                    // 0432: 16-bit numbers, 01036: 32-bit numbers (ncurses 6.1 and later)
+                    const size_t number_size = magic == 0432 ? 2 : magic == 01036 ? 4 : 0;
+                    const int names_size = read_terminfo_number(data, 2, 2);
+                    const int bools_count = read_terminfo_number(data, 4, 2);
+                    const int numbers_count = read_terminfo_number(data, 6, 2);
+                    if (number_size == 0 || names_size < 0 || bools_count < 0 ||
+                        numbers_count <= static_cast<int>(COLORS_INDEX)) {
+                        return -1;
+                    }
+
+                    size_t offset = 12 + static_cast<size_t>(names_size) + static_cast<size_t>(bools_count);
+                    offset += offset % 2; // numbers start on an even byte
+                    return read_terminfo_number(data, offset + COLORS_INDEX * number_size, number_size);
+                }
+            }
+            return -1;
+        }
+#endif
+
+#ifndef _WIN32
+        /**
+         * @brief Replies to the synchronized output probe, told apart from keys typed meanwhile
+         */
+        struct ProbeReplies {
+            bool attributes = false;          ///< The DA1 reply arrived, nothing else is coming
+            bool synchronized_output = false; ///< DECRPM reported mode 2026 as set or reset
+            std::string typed;                ///< Everything else, in the order it was read
+        };
+
+        // DA1: ESC [ ? <params> c, DECRPM: ESC [ ? 2026 ; <state> $ y
+        ProbeReplies split_probe_replies(const std::string_view bytes) {
+            ProbeReplies replies;
+            size_t position = 0;
+
+            while (position < bytes.size()) {
+                if (bytes.compare(position, 3, "\033[?") != 0) {
+                    replies.typed += bytes[position++];
+                    continue;
+                }
+
+                size_t end = position + 3;
+                while (end < bytes.size() && ((bytes[end] >= '0' && bytes[end] <= '9') || bytes[end] == ';')) {
+                    ++end;
+                }
+                const std::string_view parameters = bytes.substr(position + 3, end - position - 3);
+
+                if (end < bytes.size() && bytes[end] == 'c') {
+                    replies.attributes = true;
+                    position = end + 1;
+                } else if (end + 1 < bytes.size() && bytes[end] == '$' && bytes[end + 1] == 'y') {
+                    replies.synchronized_output = parameters == "2026;1" || parameters == "2026;2";
+                    position = end + 2;
+                } else if (end == bytes.size() || (end + 1 == bytes.size() && bytes[end] == '$')) {
+                    break; // A reply cut short, the rest has not arrived
+                } else {
+                    replies.typed += bytes[position++];
+                }
+            }
+            return replies;
+        }
+#endif
+
+        ConsoleBackend& console_backend() {
+            static ConsoleBackend console;
+            return console;
+        }
+    } // namespace
+
+    // Static member definitions
+    OutputBuffer TerminalUtils::output_;
+    TerminalBackend* TerminalUtils::backend_ = nullptr;
+    SgrState TerminalUtils::sgr_;
+    bool TerminalUtils::synchronized_output_ = false;
+    bool TerminalUtils::alternate_screen_ = false;
+    std::optional<ColorDepth> TerminalUtils::color_depth_;
+    int TerminalUtils::cursor_row_ = 0;
+    int TerminalUtils::cursor_col_ = 0;
+    std::pair<int, int> TerminalUtils::terminal_size_ = {0, 0};
+
 #ifdef _WIN32
     HANDLE TerminalUtils::hConsole = INVALID_HANDLE_VALUE;
     CONSOLE_SCREEN_BUFFER_INFO TerminalUtils::csbi = {};
@@ -22,20 +231,78 @@ namespace tui {
     bool TerminalUtils::termios_saved = false;
 #endif
 
-    void TerminalUtils::init_terminal() {
-        init_platform_terminal();
+    void TerminalUtils::init_terminal(const bool alternate_screen) {
+        backend().init();
+        refresh_terminal_size();
+        synchronized_output_ = backend().supports_synchronized_output();
+        color_depth_ = backend().color_depth();
+
+        alternate_screen_ = alternate_screen;
+        if (alternate_screen_) {
+            output_.append("\033[?1049h");
+        }
         clear_screen();
         hide_cursor();
+        flush();
     }
 
     void TerminalUtils::restore_terminal() {
+        if (synchronized_output_) {
+            // Never leave the terminal holding back its output
+            output_.append("\033[?2026l");
+        }
         show_cursor();
+        // Reset even if the tracker believes the style is clean
+        forget_style();
         reset_formatting();
-        restore_platform_terminal();
+        if (alternate_screen_) {
+            // Back to the primary screen, the terminal restores its contents and the cursor
+            output_.append("\033[?1049l");
+            alternate_screen_ = false;
+        }
+        flush();
+        forget_cursor_position();
+        backend().restore();
+    }
+
+    void TerminalUtils::set_backend(TerminalBackend* backend) {
+        if (backend == backend_) {
+            return;
+        }
+
+        // Whatever is queued belongs to the previous device
+        flush();
+        backend_ = backend;
+        forget_cursor_position();
+        forget_style();
+        terminal_size_ = {0, 0};
+        color_depth_.reset();
+    }
+
+    ColorDepth TerminalUtils::color_depth() {
+        if (!color_depth_) {
+            color_depth_ = backend().color_depth();
+        }
+        return *color_depth_;
+    }
+
+    TerminalBackend& TerminalUtils::backend() { return backend_ ? *backend_ : console_backend(); }
+
+    void TerminalUtils::begin_synchronized_update() {
+        if (synchronized_output_) {
+            output_.append("\033[?2026h");
+        }
+    }
+
+    void TerminalUtils::end_synchronized_update() {
+        if (synchronized_output_) {
+            output_.append("\033[?2026l");
+        }
     }
 
     void TerminalUtils::clear_screen() {
 #ifdef _WIN32
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             COORD coord = {0, 0};
             DWORD written;
@@ -45,25 +312,61 @@ namespace tui {
             SetConsoleCursorPosition(hConsole, coord);
         }
 #else
-        fmt::print("\033[2J\033[H");
-        flush();
+        output_.append("\033[2J\033[H");
 #endif
+        cursor_row_ = 1;
+        cursor_col_ = 1;
     }
 
     void TerminalUtils::move_cursor(int row, int col) {
 #ifdef _WIN32
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             COORD coord = {static_cast<SHORT>(col - 1), static_cast<SHORT>(row - 1)};
             SetConsoleCursorPosition(hConsole, coord);
         }
+        cursor_row_ = row;
+        cursor_col_ = col;
 #else
-        fmt::print("\033[{};{}H", row, col);
-        flush();
+        append_cursor_move(row, col);
 #endif
     }
 
+    void TerminalUtils::append_cursor_move(const int row, const int col) {
+        if (cursor_row_ > 0) {
+            const int relative = vertical_cost(cursor_row_, row) + horizontal_cost(cursor_col_, col);
+            const int carriage_return = 1 + newline_cost(cursor_row_, row) + horizontal_cost(1, col);
+            const int absolute = 4 + decimal_digits(row) + decimal_digits(col);
+
+            if (relative <= carriage_return && relative <= absolute) {
+                append_vertical(output_, cursor_row_, row);
+                append_horizontal(output_, cursor_col_, col);
+            } else if (carriage_return <= absolute) {
+                output_.append('\r');
+                append_newlines(output_, cursor_row_, row);
+                append_horizontal(output_, 1, col);
+            } else {
+                output_.format("\033[{};{}H", row, col);
+            }
+        } else {
+            output_.format("\033[{};{}H", row, col);
+        }
+
+        cursor_row_ = row;
+        cursor_col_ = col;
+    }
+
+    void TerminalUtils::advance_cursor(const int columns) {
+        cursor_col_ += columns;
+        // Past the last column the terminal is about to wrap, where exactly the cursor sits is up to it
+        if (terminal_size_.second <= 0 || cursor_col_ > terminal_size_.second) {
+            cursor_row_ = 0;
+        }
+    }
+
     void TerminalUtils::hide_cursor() {
 #ifdef _WIN32
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             CONSOLE_CURSOR_INFO cursorInfo;
             GetConsoleCursorInfo(hConsole, &cursorInfo);
@@ -71,13 +374,13 @@ namespace tui {
             SetConsoleCursorInfo(hConsole, &cursorInfo);
         }
 #else
-        fmt::print("\033[?25l");
-        flush();
+        output_.append("\033[?25l");
 #endif
     }
 
     void TerminalUtils::show_cursor() {
 #ifdef _WIN32
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             CONSOLE_CURSOR_INFO cursorInfo;
             GetConsoleCursorInfo(hConsole, &cursorInfo);
@@ -85,35 +388,25 @@ namespace tui {
             SetConsoleCursorInfo(hConsole, &cursorInfo);
         }
 #else
-        fmt::print("\033[?25h");
-        flush();
+        output_.append("\033[?25h");
 #endif
     }
 
     std::pair<int, int> TerminalUtils::get_terminal_size() {
-#ifdef _WIN32
-        if (hConsole != INVALID_HANDLE_VALUE) {
-            GetConsoleScreenBufferInfo(hConsole, &csbi);
-            int width = csbi.srWindow.Right - csbi.srWindow.Left + 1;
-            int height = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
-            return {height, width};
+        if (terminal_size_.first <= 0) {
+            return refresh_terminal_size();
         }
-        return {25, 80}; // Default fallback
-#else
-        winsize w{};
-        // if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0) {
-        //   return {w.ws_row, w.ws_col};
-        // }
-        // return {25, 80}; // Default fallback
+        return terminal_size_;
+    }
 
-        return ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0
-            ? std::make_pair(static_cast<int>(w.ws_row), static_cast<int>(w.ws_col))
-            : std::make_pair(25, 80);
-#endif
+    std::pair<int, int> TerminalUtils::refresh_terminal_size() {
+        terminal_size_ = backend().query_size();
+        return terminal_size_;
     }
 
     void TerminalUtils::set_color(Color color) {
 #ifdef _WIN32
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             WORD attributes = 0;
             switch (color) {
@@ -172,14 +465,13 @@ namespace tui {
             SetConsoleTextAttribute(hConsole, attributes);
         }
 #else
-        fmt::print("\033[{}m", (color == Color::RESET) ? 0 : static_cast<int>(color));
-
-        flush();
+        set_foreground(static_cast<int>(color));
 #endif
     }
 
     void TerminalUtils::set_color(extras::AccentColor color) {
 #ifdef _WIN32
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             WORD attributes = 0;
             switch (color) {
@@ -238,55 +530,29 @@ namespace tui {
             SetConsoleTextAttribute(hConsole, attributes);
         }
 #else
-        fmt::print("\033[{}m", (color == extras::AccentColor::RESET) ? 0 : static_cast<int>(color));
-
-        flush();
+        set_foreground(static_cast<int>(color));
 #endif
     }
 
     size_t TerminalUtils::get_visible_string_length(const std::string& string) {
-        size_t length = 0;
-        auto in_escape_sequence = false;
-
-        for (size_t i = 0; i < string.length(); ++i) {
-            const unsigned char c = static_cast<unsigned char>(string[i]);
-
-            if (c == '\033') {
-                in_escape_sequence = true;
-            }
-
-            if (!in_escape_sequence) {
-                // Simple UTF-8 check: only increment for the first byte of a sequence
-                // (bits 10xxxxxx are continuation bytes)
-                if ((c & 0xC0) != 0x80) {
-                    length++;
-                }
-            }
-
-            if (in_escape_sequence && c == 'm') {
-                in_escape_sequence = false;
-            }
-        }
-
-        return length;
+        return unicode::display_width(string);
     }
 
     void TerminalUtils::set_color_rgb(uint8_t r, uint8_t g, uint8_t b) {
-        // #ifdef _WIN32
-        //         printf("\033[38;2;%d;%d;%dm", r, g, b);
-        // #else
-        fmt::print("\033[38;2;{};{};{}m", static_cast<int>(r), static_cast<int>(g), static_cast<int>(b));
-        // #endif
-        flush();
-    }
-
-    void TerminalUtils::set_color_rgb(const extras::GradientColor color) {
+        const CellColor color = downsample(CellStyle::from_rgb(r, g, b).fg, color_depth());
 #ifdef _WIN32
-        if (!is_wt) {
+        if (color.type == CellColor::Type::ANSI) {
+            // Classic consoles get the attribute through the console API
+            set_color(static_cast<Color>(color.code));
             return;
         }
 #endif
+        CellStyle style = sgr_.current();
+        style.fg = color;
+        apply_style(style);
+    }
 
+    void TerminalUtils::set_color_rgb(const extras::GradientColor color) {
         auto [r, g, b] = color.get_color();
         set_color_rgb(r, g, b);
     }
@@ -294,6 +560,7 @@ namespace tui {
     void TerminalUtils::set_style(Style style) {
 #ifdef _WIN32
         // Windows console doesn't support all styles, so we'll do our best
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             switch (style) {
             case Style::BOLD:
@@ -310,69 +577,98 @@ namespace tui {
             }
         }
 #else
-        fmt::print("\033[{}m", static_cast<int>(style));
-        // std::cout << "\033[" << static_cast<int>(style) << "m";
-        flush();
+        CellStyle next = sgr_.current();
+        switch (style) {
+        case Style::RESET:
+            next = CellStyle{};
+            break;
+        case Style::BOLD:
+            next.attributes |= CellStyle::BOLD;
+            break;
+        case Style::DIM:
+            next.attributes |= CellStyle::DIM;
+            break;
+        case Style::ITALIC:
+            next.attributes |= CellStyle::ITALIC;
+            break;
+        case Style::UNDERLINE:
+            next.attributes |= CellStyle::UNDERLINE;
+            break;
+        case Style::BLINK:
+            next.attributes |= CellStyle::BLINK;
+            break;
+        case Style::REVERSE:
+            next.attributes |= CellStyle::REVERSE;
+            break;
+        case Style::STRIKETHROUGH:
+            next.attributes |= CellStyle::STRIKETHROUGH;
+            break;
+        }
+        apply_style(next);
 #endif
     }
 
     void TerminalUtils::reset_formatting() {
 #ifdef _WIN32
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             SetConsoleTextAttribute(hConsole, csbi.wAttributes);
         }
 #else
-        fmt::print("\033[0m");
-        flush();
+        apply_style(CellStyle{});
 #endif
     }
 
+    void TerminalUtils::set_foreground(const int code) {
+        // Code 0 (RESET) clears everything, like the plain SGR it stands for
+        if (code == 0) {
+            apply_style(CellStyle{});
+            return;
+        }
+
+        CellStyle style = sgr_.current();
+        style.fg.type = CellColor::Type::ANSI;
+        style.fg.code = static_cast<uint8_t>(code);
+        apply_style(style);
+    }
+
 
     void TerminalUtils::draw_horizontal_line(const int row, const int start_col, const int length, const char ch) {
         move_cursor(row, start_col);
-        for (auto i = 0; i < length; ++i) {
-            fmt::print("{}", ch);
-        }
-
-        flush();
+        output_.append(std::string(std::max(0, length), ch));
+        advance_cursor(std::max(0, length));
     }
 
     void TerminalUtils::draw_vertical_line(int start_row, int col, int length, char ch) {
         for (int i = 0; i < length; ++i) {
             move_cursor(start_row + i, col);
-            fmt::print("{}", ch);
+            output_.append(ch);
+            advance_cursor(1);
         }
-
-        flush();
     }
 
     void TerminalUtils::draw_box(int top_row, int left_col, int width, int height) {
         // Top border
-        move_cursor(top_row, left_col);
-        fmt::print("+");
-        for (int i = 1; i < width - 1; ++i) {
-            fmt::print("-");
-        }
+        const std::string horizontal = "+" + std::string(std::max(0, width - 2), '-') + "+";
 
-        fmt::print("+");
+        move_cursor(top_row, left_col);
+        output_.append(horizontal);
+        advance_cursor(static_cast<int>(horizontal.size()));
 
         // Side borders
         for (int i = 1; i < height - 1; ++i) {
             move_cursor(top_row + i, left_col);
-            fmt::print("|");
+            output_.append('|');
+            advance_cursor(1);
             move_cursor(top_row + i, left_col + width - 1);
-            fmt::print("|");
+            output_.append('|');
+            advance_cursor(1);
         }
 
         // Bottom border
         move_cursor(top_row + height - 1, left_col);
-        fmt::print("+");
-        for (int i = 1; i < width - 1; ++i) {
-            fmt::print("-");
-        }
-        fmt::print("+");
-
-        flush();
+        output_.append(horizontal);
+        advance_cursor(static_cast<int>(horizontal.size()));
     }
 
     void TerminalUtils::print_centered(const std::string& text, int width, int row) {
@@ -383,36 +679,43 @@ namespace tui {
             move_cursor(row, 1);
         }
 
-        fmt::print("{}", padded_text);
-        flush();
+        output_.append(padded_text);
+        forget_cursor_position();
+        if (text.find('\033') != std::string::npos) {
+            forget_style();
+        }
     }
 
     void TerminalUtils::print_at(int row, int col, const std::string& text) {
         move_cursor(row, col);
-        fmt::print("{}", text);
-        flush();
+        output_.append(text);
+        forget_cursor_position();
+        if (text.find('\033') != std::string::npos) {
+            forget_style();
+        }
     }
 
     void TerminalUtils::save_cursor_position() {
 #ifdef _WIN32
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             GetConsoleScreenBufferInfo(hConsole, &csbi);
         }
 #else
-        fmt::print("\033[s");
-        flush();
+        output_.append("\033[s");
 #endif
     }
 
     void TerminalUtils::restore_cursor_position() {
 #ifdef _WIN32
+        flush();
         if (hConsole != INVALID_HANDLE_VALUE) {
             SetConsoleCursorPosition(hConsole, csbi.dwCursorPosition);
         }
 #else
-        fmt::print("\033[u");
-        flush();
+        output_.append("\033[u");
 #endif
+        forget_cursor_position();
     }
 
     void TerminalUtils::set_echo(bool enable) {
@@ -449,7 +752,7 @@ namespace tui {
 #endif
     }
 
-    void TerminalUtils::flush() { std::fflush(stdout); }
+    void TerminalUtils::flush() { output_.flush(backend()); }
 
     int TerminalUtils::get_centered_col(int content_width) {
         auto [height, width] = get_terminal_size();
@@ -528,14 +831,52 @@ namespace tui {
             struct termios new_termios = original_termios;
             new_termios.c_lflag &= ~(ICANON | ECHO);
             new_termios.c_iflag &= ~ICRNL;
-            new_termios.c_cc[VMIN] = 1;
+            // Non-blocking reads, Input waits with select() and then takes whole bursts at once
+            new_termios.c_cc[VMIN] = 0;
             new_termios.c_cc[VTIME] = 0;
             tcsetattr(STDIN_FILENO, TCSANOW, &new_termios);
-            setvbuf(stdout, nullptr, _IONBF, 0);
         }
 #endif
     }
 
+    bool TerminalUtils::query_synchronized_output() {
+#ifdef _WIN32
+        return false;
+#else
+        if (!termios_saved || !isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) {
+            return false;
+        }
+
+        // DECRQM for mode 2026 followed by a primary device attributes request. Every terminal answers DA1,
+        // so its reply marks the end of the exchange even when DECRQM is ignored.
+        output_.append("\033[?2026$p\033[c");
+        flush();
+
+        constexpr int timeout_ms = 200;
+        std::string reply;
+        ProbeReplies replies;
+
+        while (!replies.attributes && reply.size() < 256) {
+            pollfd pfd{STDIN_FILENO, POLLIN, 0};
+            if (poll(&pfd, 1, timeout_ms) <= 0) {
+                break;
+            }
+
+            char buffer[64];
+            const ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (count <= 0) {
+                break;
+            }
+            reply.append(buffer, static_cast<size_t>(count));
+            replies = split_probe_replies(reply);
+        }
+
+        // Keys typed while waiting for the reply are handed to the input buffer instead of being lost
+        Input::push_pending(replies.typed);
+        return replies.synchronized_output;
+#endif
+    }
+
     void TerminalUtils::restore_platform_terminal() {
 #ifdef _WIN32
         if (hConsole != INVALID_HANDLE_VALUE) {
@@ -548,24 +889,124 @@ namespace tui {
         if (termios_saved) {
             tcflush(STDIN_FILENO, TCIFLUSH);
             tcsetattr(STDIN_FILENO, TCSANOW, &original_termios);
-            setvbuf(stdout, nullptr, _IOLBF, BUFSIZ); // Restore line buffering
             termios_saved = false;
         }
 #endif
     }
 
-    std::optional<tui::KeyEvent> TerminalManager::get_key_input() {
-        if (!Input::key_available()) {
-            return std::nullopt;
+    void ConsoleBackend::init() {
+        TerminalUtils::init_platform_terminal();
+        synchronized_output_ = TerminalUtils::query_synchronized_output();
+#ifndef _WIN32
+        events_.open(STDIN_FILENO);
+#endif
+    }
+
+    void ConsoleBackend::restore() {
+        TerminalUtils::restore_platform_terminal();
+        Input::discard_pending();
+        events_.close();
+    }
+
+    size_t ConsoleBackend::write(const std::string_view bytes) {
+        // Keep ordering with anything printed through stdio (e.g. from user callbacks)
+        std::fflush(stdout);
+
+        size_t written = 0;
+#ifdef _WIN32
+        written = std::fwrite(bytes.data(), 1, bytes.size(), stdout);
+        std::fflush(stdout);
+#else
+        while (written < bytes.size()) {
+            const ssize_t result = ::write(STDOUT_FILENO, bytes.data() + written, bytes.size() - written);
+
+            if (result < 0) {
+                if (errno == EINTR || errno == EAGAIN) {
+                    continue;
+                }
+                break;
+            }
+            written += static_cast<size_t>(result);
+        }
+#endif
+        return written;
+    }
+
+    std::optional<KeyEvent> ConsoleBackend::read_key() { return Input::read_event(); }
+
+    bool ConsoleBackend::wait_for_input(const int timeout_ms) { return Input::wait_for_input(timeout_ms); }
+
+    WaitResult ConsoleBackend::wait(const int timeout_ms) {
+        if (!events_.is_open()) {
+            return TerminalBackend::wait(timeout_ms);
+        }
+
+        // Buffered input first, half an escape sequence shortens the sleep to its timeout
+        const int ready = Input::milliseconds_until_ready();
+        WaitResult result;
+        if (ready == 0) {
+            result.input = true;
+            return result;
+        }
+
+        const bool escape_pending = ready > 0 && (timeout_ms < 0 || ready <= timeout_ms);
+        result = events_.wait(escape_pending ? ready : timeout_ms);
+        result.input = result.input || escape_pending;
+        return result;
+    }
+
+    std::pair<int, int> ConsoleBackend::query_size() {
+#ifdef _WIN32
+        if (TerminalUtils::hConsole != INVALID_HANDLE_VALUE) {
+            GetConsoleScreenBufferInfo(TerminalUtils::hConsole, &TerminalUtils::csbi);
+            int width = TerminalUtils::csbi.srWindow.Right - TerminalUtils::csbi.srWindow.Left + 1;
+            int height = TerminalUtils::csbi.srWindow.Bottom - TerminalUtils::csbi.srWindow.Top + 1;
+            return {height, width};
+        }
+        return {25, 80}; // Default fallback
+#else
+        winsize w{};
+        return ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0
+            ? std::make_pair(static_cast<int>(w.ws_row), static_cast<int>(w.ws_col))
+            : std::make_pair(25, 80);
+#endif
+    }
+
+    ColorDepth ConsoleBackend::color_depth() {
+#ifdef _WIN32
+        // Windows Terminal renders 24-bit color, the classic console gets the 16 console colors
+        return TerminalUtils::is_wt ? ColorDepth::TRUECOLOR : ColorDepth::ANSI16;
+#else
+        if (const char* colorterm = std::getenv("COLORTERM")) {
+            if (const std::string_view value(colorterm); value == "truecolor" || value == "24bit") {
+                return ColorDepth::TRUECOLOR;
+            }
         }
 
-        auto [key, character] = Input::get_input();
-        return tui::KeyEvent(key, character);
+        const char* term_env = std::getenv("TERM");
+        const std::string term = term_env ? term_env : "";
+        if (term.empty() || term == "dumb") {
+            return ColorDepth::ANSI16;
+        }
+        if (term.find("-direct") != std::string::npos) {
+            return ColorDepth::TRUECOLOR;
+        }
+
+        if (const int colors = terminfo_colors(term); colors > 0) {
+            if (colors >= 1 << 24) {
+                return ColorDepth::TRUECOLOR;
+            }
+            return colors >= 256 ? ColorDepth::INDEXED256 : ColorDepth::ANSI16;
+        }
+        return term.find("256color") != std::string::npos ? ColorDepth::INDEXED256 : ColorDepth::ANSI16;
+#endif
     }
 
-    bool TerminalManager::wait_for_input(int timeout_ms) { return Input::wait_for_input(timeout_ms); }
+    std::optional<tui::KeyEvent> TerminalManager::get_key_input() { return TerminalUtils::backend().read_key(); }
+
+    bool TerminalManager::wait_for_input(int timeout_ms) { return TerminalUtils::backend().wait_for_input(timeout_ms); }
 
-    bool TerminalManager::key_available() { return Input::key_available(); }
+    bool TerminalManager::key_available() { return TerminalUtils::backend().wait_for_input(0); }
 
 
 } // namespace tui
@@ -0,0 +1,124 @@
+#include "core/text_wrap.hpp"
+#include <functional>
+#include "core/unicode.hpp"
+
+namespace tui {
+
+    namespace {
+        // Length of the escape sequence at text[i], CSI sequences run up to their final byte
+        size_t escape_length(const std::string_view text, const size_t i) {
+            if (i + 1 < text.size() && text[i + 1] == '[') {
+                size_t end = i + 2;
+                while (end < text.size() && (text[end] < 0x40 || text[end] > 0x7E)) {
+                    ++end;
+                }
+                return std::min(end + 1, text.size()) - i;
+            }
+            return std::min<size_t>(2, text.size() - i);
+        }
+    } // namespace
+
+    std::vector<TextLine> wrap_text(const std::string_view text, const int width, const bool center) {
+        std::vector<TextLine> lines;
+        if (text.empty()) {
+            return lines;
+        }
+
+        const auto push_line = [&](const size_t begin, const size_t end, const int line_width) {
+            TextLine line{begin, end - begin, line_width, 0};
+            if (center && width > line_width) {
+                line.indent = (width - line_width) / 2;
+            }
+            lines.push_back(line);
+        };
+
+        size_t line_begin = 0;
+        int line_width = 0;
+        size_t space = std::string_view::npos; ///< Last space on the current line
+        int width_before_space = 0;
+
+        for (size_t i = 0; i < text.size();) {
+            const char c = text[i];
+
+            if (c == '\n') {
+                push_line(line_begin, i, line_width);
+                line_begin = i + 1;
+                line_width = 0;
+                space = std::string_view::npos;
+                ++i;
+                continue;
+            }
+
+            if (c == '\033') {
+                i += escape_length(text, i);
+                continue;
+            }
+
+            size_t next = i;
+            const int glyph_width = unicode::code_point_width(unicode::decode_utf8(text, next));
+
+            if (width > 0 && glyph_width > 0 && line_width + glyph_width > width && line_width > 0) {
+                if (c == ' ') {
+                    // The line is full right before a space, break there and drop the space
+                    push_line(line_begin, i, line_width);
+                    line_begin = next;
+                    line_width = 0;
+                    space = std::string_view::npos;
+                    i = next;
+                    continue;
+                }
+
+                if (space != std::string_view::npos) {
+                    // Break at the last space, the space itself goes away. A space that starts the line
+                    // leaves nothing before it to keep.
+                    if (space != line_begin) {
+                        push_line(line_begin, space, width_before_space);
+                    }
+                    line_width -= width_before_space + 1;
+                    line_begin = space + 1;
+                    space = std::string_view::npos;
+                }
+
+                if (line_width + glyph_width > width && line_width > 0) {
+                    // A single word wider than the line
+                    push_line(line_begin, i, line_width);
+                    line_begin = i;
+                    line_width = 0;
+                }
+            }
+
+            if (c == ' ') {
+                space = i;
+                width_before_space = line_width;
+            }
+
+            line_width += glyph_width;
+            i = next;
+        }
+
+        // Nothing left after a break at a trailing space, unlike after a trailing newline
+        if (line_begin < text.size() || text.back() == '\n' || lines.empty()) {
+            push_line(line_begin, text.size(), line_width);
+        }
+        return lines;
+    }
+
+    const WrappedText& WrapCache::get(const std::string_view text, const int width, const bool center) {
+        const size_t hash = std::hash<std::string_view>{}(text);
+
+        for (const auto& entry : entries_) {
+            if (entry.hash == hash && entry.width == width && entry.center == center && entry.wrapped.text == text) {
+                return entry.wrapped;
+            }
+        }
+
+        if (entries_.size() >= MAX_ENTRIES) {
+            entries_.erase(entries_.begin());
+        }
+
+        WrappedText wrapped{std::string(text), wrap_text(text, width, center)};
+        entries_.push_back(Entry{hash, width, center, std::move(wrapped)});
+        return entries_.back().wrapped;
+    }
+
+} // namespace tui
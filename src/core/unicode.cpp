@@ -0,0 +1,374 @@
+#include "core/unicode.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define REBUILDTUI_HAS_SSE2 1
+#include <immintrin.h>
+#endif
+
+#if defined(REBUILDTUI_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define REBUILDTUI_HAS_AVX2 1
+#define REBUILDTUI_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#elif defined(REBUILDTUI_HAS_SSE2) && defined(__AVX2__)
+#define REBUILDTUI_HAS_AVX2 1
+#define REBUILDTUI_TARGET_AVX2
+#endif
+
+// The scan loops are inlined into each kernel so the block code is not called through a target boundary
+#if defined(__GNUC__) || defined(__clang__)
+#define REBUILDTUI_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define REBUILDTUI_ALWAYS_INLINE __forceinline
+#else
+#define REBUILDTUI_ALWAYS_INLINE inline
+#endif
+
+namespace tui::unicode {
+
+    namespace {
+        constexpr unsigned char ESCAPE = 0x1B;
+
+        bool is_lead_byte(const unsigned char c) { return (c & 0xC0) != 0x80; }
+
+        int popcount(unsigned int mask) {
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__POPCNT__)
+            return __builtin_popcount(mask);
+#else
+            // Without -mpopcnt the builtin is a libgcc call, too slow for once per block
+            mask = mask - ((mask >> 1) & 0x55555555u);
+            mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+            return static_cast<int>((((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+        }
+
+        int lowest_bit(const unsigned int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctz(mask);
+#else
+            int bit = 0;
+            while (((mask >> bit) & 1u) == 0) {
+                ++bit;
+            }
+            return bit;
+#endif
+        }
+
+        /**
+         * @brief Skip an escape sequence starting at position, returns the index after its final 'm'
+         */
+        size_t skip_escape(const std::string_view text, const size_t position) {
+            const void* end = std::memchr(text.data() + position, 'm', text.size() - position);
+            return end ? static_cast<size_t>(static_cast<const char*>(end) - text.data()) + 1 : text.size();
+        }
+
+        /**
+         * @brief Count lead bytes from position up to the next escape byte (or the end)
+         *
+         * Block kernels only differ in how much plain text they consume per step,
+         * the remainder is always handled here.
+         */
+        size_t count_tail(const std::string_view text, size_t& position) {
+            size_t length = 0;
+            for (; position < text.size(); ++position) {
+                const auto c = static_cast<unsigned char>(text[position]);
+                if (c == ESCAPE) {
+                    break;
+                }
+                length += is_lead_byte(c);
+            }
+            return length;
+        }
+
+        /**
+         * @brief Consume printable ASCII from position, stopping at the first byte that needs decoding
+         */
+        size_t ascii_tail(const std::string_view text, size_t& position) {
+            const size_t start = position;
+            while (position < text.size()) {
+                const auto c = static_cast<unsigned char>(text[position]);
+                if (c < 0x20 || c >= 0x7F) {
+                    break;
+                }
+                ++position;
+            }
+            return position - start;
+        }
+
+        /**
+         * @brief Columns of the bytes flagged in special, a bit per byte of the block starting at block
+         *
+         * The unflagged bytes are printable ASCII and counted by the caller. Only lead bytes are
+         * decoded and looked up, the continuation bytes each code point consumes are cleared from
+         * the mask, as are those of a code point that started in the previous block.
+         */
+        REBUILDTUI_ALWAYS_INLINE size_t special_columns(const std::string_view text, const size_t block,
+                                                        unsigned int special, size_t& decoded_until) {
+            if (decoded_until > block) {
+                special &= ~((1u << (decoded_until - block)) - 1);
+            }
+
+            size_t width = 0;
+            while (special != 0) {
+                size_t position = block + static_cast<size_t>(lowest_bit(special));
+                width += static_cast<size_t>(code_point_width(decode_utf8(text, position)));
+                decoded_until = position;
+
+                const size_t consumed = position - block;
+                special = consumed >= 32 ? 0 : special & ~((1u << consumed) - 1);
+            }
+            return width;
+        }
+
+#ifdef REBUILDTUI_HAS_SSE2
+        size_t count_plain_sse2(const std::string_view text, size_t& position) {
+            const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+            const __m128i escape = _mm_set1_epi8(static_cast<char>(ESCAPE));
+            // Continuation bytes 0x80..0xBF are exactly the signed bytes below -64
+            const __m128i continuation_limit = _mm_set1_epi8(-64);
+
+            size_t length = 0;
+            while (position + 16 <= text.size()) {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+                const auto escapes = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, escape)));
+                auto continuation =
+                    static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmplt_epi8(block, continuation_limit)));
+
+                if (escapes != 0) {
+                    const int stop = lowest_bit(escapes);
+                    continuation &= (1u << stop) - 1;
+                    length += static_cast<size_t>(stop - popcount(continuation));
+                    position += static_cast<size_t>(stop);
+                    return length;
+                }
+
+                length += static_cast<size_t>(16 - popcount(continuation));
+                position += 16;
+            }
+            return length + count_tail(text, position);
+        }
+
+        // Whole strings of at least 16 bytes, escape sequences are skipped in the same pass
+        size_t columns_sse2(const std::string_view text) {
+            const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+            const __m128i escape = _mm_set1_epi8(static_cast<char>(ESCAPE));
+            const __m128i final_byte = _mm_set1_epi8('m');
+            // Signed compare: controls and every byte >= 0x80 are below 0x20
+            const __m128i printable_min = _mm_set1_epi8(0x20);
+            const __m128i del = _mm_set1_epi8(0x7F);
+
+            size_t width = 0;
+            size_t position = 0;
+            size_t decoded_until = 0;
+            while (position < text.size()) {
+                // The last block is loaded flush with the end, bytes it shares with the previous one are shifted out
+                const size_t base = std::min(position, text.size() - 16);
+                const auto shift = static_cast<unsigned int>(position - base);
+
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + base));
+                const unsigned int escapes =
+                    static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, escape))) >> shift;
+                unsigned int special = static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(
+                                           _mm_cmplt_epi8(block, printable_min), _mm_cmpeq_epi8(block, del)))) >>
+                                       shift;
+
+                // A branch rather than a select, so the next load does not wait for this block's compares
+                if (escapes == 0) {
+                    width += static_cast<size_t>(static_cast<int>(16 - shift) - popcount(special));
+                    width += special_columns(text, position, special, decoded_until);
+                    position += 16 - shift;
+                    continue;
+                }
+
+                const int end = lowest_bit(escapes);
+                special &= (1u << end) - 1;
+                width += static_cast<size_t>(end - popcount(special));
+                width += special_columns(text, position, special, decoded_until);
+
+                // The closing 'm' of a color code is usually in the same block
+                const unsigned int finals =
+                    (static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, final_byte))) >> shift) &
+                    ~((2u << end) - 1);
+                position = finals != 0 ? position + static_cast<size_t>(lowest_bit(finals)) + 1
+                                       : skip_escape(text, position + static_cast<size_t>(end));
+            }
+            return width;
+        }
+#endif
+
+#ifdef REBUILDTUI_HAS_AVX2
+        REBUILDTUI_TARGET_AVX2 size_t count_plain_avx2(const std::string_view text, size_t& position) {
+            const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+            const __m256i escape = _mm256_set1_epi8(static_cast<char>(ESCAPE));
+            const __m256i continuation_limit = _mm256_set1_epi8(-64);
+
+            size_t length = 0;
+            while (position + 32 <= text.size()) {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+                const auto escapes = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, escape)));
+                auto continuation =
+                    static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(continuation_limit, block)));
+
+                if (escapes != 0) {
+                    const int stop = lowest_bit(escapes);
+                    continuation &= (1u << stop) - 1;
+                    length += static_cast<size_t>(stop - _mm_popcnt_u32(continuation));
+                    position += static_cast<size_t>(stop);
+                    return length;
+                }
+
+                length += static_cast<size_t>(32 - _mm_popcnt_u32(continuation));
+                position += 32;
+            }
+            return length + count_tail(text, position);
+        }
+
+        REBUILDTUI_TARGET_AVX2 size_t columns_avx2(const std::string_view text) {
+            if (text.size() < 32) {
+                return columns_sse2(text);
+            }
+
+            const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+            const __m256i escape = _mm256_set1_epi8(static_cast<char>(ESCAPE));
+            const __m256i final_byte = _mm256_set1_epi8('m');
+            const __m256i printable_min = _mm256_set1_epi8(0x20);
+            const __m256i del = _mm256_set1_epi8(0x7F);
+
+            size_t width = 0;
+            size_t position = 0;
+            size_t decoded_until = 0;
+            while (position < text.size()) {
+                const size_t base = std::min(position, text.size() - 32);
+                const auto shift = static_cast<unsigned int>(position - base);
+
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + base));
+                const unsigned int escapes =
+                    static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, escape))) >> shift;
+                unsigned int special =
+                    static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_or_si256(
+                        _mm256_cmpgt_epi8(printable_min, block), _mm256_cmpeq_epi8(block, del)))) >>
+                    shift;
+
+                if (escapes == 0) {
+                    width += static_cast<size_t>(static_cast<int>(32 - shift) - _mm_popcnt_u32(special));
+                    width += special_columns(text, position, special, decoded_until);
+                    position += 32 - shift;
+                    continue;
+                }
+
+                const int end = lowest_bit(escapes);
+                special &= (1u << end) - 1;
+                width += static_cast<size_t>(end - _mm_popcnt_u32(special));
+                width += special_columns(text, position, special, decoded_until);
+
+                // 2u << 31 wraps to 0 and leaves no bits, skip_escape() then searches past the block
+                const unsigned int finals =
+                    (static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, final_byte))) >> shift) &
+                    ~((2u << end) - 1);
+                position = finals != 0 ? position + static_cast<size_t>(lowest_bit(finals)) + 1
+                                       : skip_escape(text, position + static_cast<size_t>(end));
+            }
+            return width;
+        }
+#endif
+
+        using PlainKernel = size_t (*)(std::string_view, size_t&);
+
+        template <PlainKernel Kernel>
+        REBUILDTUI_ALWAYS_INLINE size_t scan(const std::string_view text) {
+            size_t length = 0;
+            size_t position = 0;
+
+            while (position < text.size()) {
+                length += Kernel(text, position);
+                if (position < text.size()) {
+                    position = skip_escape(text, position);
+                }
+            }
+            return length;
+        }
+
+        template <PlainKernel AsciiRun>
+        REBUILDTUI_ALWAYS_INLINE size_t measure(const std::string_view text) {
+            size_t width = 0;
+            size_t position = 0;
+
+            while (position < text.size()) {
+                width += AsciiRun(text, position);
+                if (position >= text.size()) {
+                    break;
+                }
+
+                if (text[position] == '\033') {
+                    position = skip_escape(text, position);
+                } else {
+                    width += static_cast<size_t>(code_point_width(decode_utf8(text, position)));
+                }
+            }
+            return width;
+        }
+
+#ifdef REBUILDTUI_HAS_SSE2
+        size_t visible_length_sse2(const std::string_view text) { return scan<count_plain_sse2>(text); }
+        size_t display_width_sse2(const std::string_view text) { return columns_sse2(text); }
+#endif
+
+#ifdef REBUILDTUI_HAS_AVX2
+        REBUILDTUI_TARGET_AVX2 size_t visible_length_avx2(const std::string_view text) {
+            return scan<count_plain_avx2>(text);
+        }
+        REBUILDTUI_TARGET_AVX2 size_t display_width_avx2(const std::string_view text) {
+            return columns_avx2(text);
+        }
+#endif
+
+        struct Dispatch {
+            size_t (*visible_length)(std::string_view);
+            size_t (*display_width)(std::string_view);
+            const char* name;
+        };
+
+        Dispatch select_kernel() {
+#if defined(REBUILDTUI_HAS_AVX2) && !defined(__GNUC__) && !defined(__clang__)
+            // Built with /arch:AVX2, no runtime check needed
+            return {visible_length_avx2, display_width_avx2, "avx2"};
+#elif defined(REBUILDTUI_HAS_SSE2)
+#ifdef REBUILDTUI_HAS_AVX2
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+                return {visible_length_avx2, display_width_avx2, "avx2"};
+            }
+#endif
+            return {visible_length_sse2, display_width_sse2, "sse2"};
+#else
+            return {visible_length_scalar, display_width_scalar, "scalar"};
+#endif
+        }
+
+        const Dispatch& kernel() {
+            static const Dispatch dispatch = select_kernel();
+            return dispatch;
+        }
+    } // namespace
+
+    size_t visible_length(const std::string_view text) {
+        // Short strings (prefixes, counters) are not worth the dispatch
+        if (text.size() < 16) {
+            return visible_length_scalar(text);
+        }
+        return kernel().visible_length(text);
+    }
+
+    size_t visible_length_scalar(const std::string_view text) { return scan<count_tail>(text); }
+
+    size_t display_width(const std::string_view text) {
+        if (text.size() < 16) {
+            return display_width_scalar(text);
+        }
+        return kernel().display_width(text);
+    }
+
+    size_t display_width_scalar(const std::string_view text) { return measure<ascii_tail>(text); }
+
+    const char* visible_length_kernel() { return kernel().name; }
+
+} // namespace tui::unicode
@@ -2,20 +2,32 @@
 
 
 #include "core/terminal.hpp"
+#include "core/unicode.hpp"
 #include "theme/colors.hpp"
 
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
 #include <fmt/core.h>
+#include <limits>
 #include <random>
 #include <sstream>
 #include <utility>
 
 namespace tui {
 
-    // get ANSI sequence from Color
-    static std::string get_color_sequence(const extras::Color& color) {
+    // get ANSI sequence from Color, RGB colors reduced to what the terminal displays
+    static std::string get_color_sequence(const extras::Color& color, const ColorDepth depth) {
         if (color.type == extras::Color::Type::ANSI) {
             return "\033[" + std::to_string(static_cast<int>(color.ansi_color)) + "m";
         } else if (color.type == extras::Color::Type::RGB) {
+            const CellColor reduced = downsample(CellStyle::from_color(color).fg, depth);
+            if (reduced.type == CellColor::Type::ANSI) {
+                return "\033[" + std::to_string(reduced.code) + "m";
+            }
+            if (reduced.type == CellColor::Type::INDEXED) {
+                return "\033[38;5;" + std::to_string(reduced.code) + "m";
+            }
             return "\033[38;2;" + std::to_string(color.r) + ";" + std::to_string(color.g) + ";" +
                 std::to_string(color.b) + "m";
         }
@@ -24,32 +36,48 @@ namespace tui {
     NavigationTUI::NavigationTUI() :
         current_state_(NavigationState::MAIN_MENU), current_section_index_(0), current_selection_index_(0),
         current_page_(0), current_section_page_{0}, running_(false), needs_redraw_(true), previous_width_{0},
-        previous_height_{0} {
+        previous_height_{0}, gradient_rng_(std::random_device{}()) {
         config_ = Config{};
         terminal_manager_ = std::make_unique<TerminalManager>();
+        compile_theme();
     }
 
     NavigationTUI::NavigationTUI(Config config) :
         current_state_(NavigationState::MAIN_MENU), current_section_index_(0), current_selection_index_(0),
         current_page_(0), current_section_page_{0}, config_(std::move(config)), running_(false), needs_redraw_(true),
-        previous_width_{0}, previous_height_{0} {
+        previous_width_{0}, previous_height_{0}, gradient_rng_(std::random_device{}()) {
         terminal_manager_ = std::make_unique<TerminalManager>();
+        compile_theme();
     }
 
-    void NavigationTUI::add_section(const Section& section) { sections_.push_back(section); }
+    void NavigationTUI::add_section(const Section& section) {
+        sections_.push_back(section);
+        invalidate_selected_counts();
+        invalidate_layout();
+    }
 
-    void NavigationTUI::add_section(Section&& section) { sections_.push_back(std::move(section)); }
+    void NavigationTUI::add_section(Section&& section) {
+        sections_.push_back(std::move(section));
+        invalidate_selected_counts();
+        invalidate_layout();
+    }
 
     void NavigationTUI::add_sections(const std::vector<Section>& sections) {
         sections_.insert(sections_.end(), sections.begin(), sections.end());
+        invalidate_selected_counts();
+        invalidate_layout();
     }
 
     void NavigationTUI::add_sections(std::vector<Section>&& sections) {
         sections_.insert(sections_.end(), std::make_move_iterator(sections.begin()),
                          std::make_move_iterator(sections.end()));
+        invalidate_selected_counts();
+        invalidate_layout();
     }
 
     Section* NavigationTUI::get_section(size_t index) {
+        // The caller may change selections through the pointer
+        invalidate_selected_counts();
         return (index < sections_.size()) ? &sections_[index] : nullptr;
     }
 
@@ -58,6 +86,7 @@ namespace tui {
     }
 
     Section* NavigationTUI::get_section_by_name(const std::string& name) {
+        invalidate_selected_counts();
 #if __cplusplus >= 202002L
         const auto it =
             std::ranges::find_if(sections_, [&name](const Section& section) { return section.name == name; });
@@ -87,6 +116,8 @@ namespace tui {
             using diff_t = typename decltype(sections_)::difference_type;
 
             sections_.erase(sections_.begin() + static_cast<diff_t>(index));
+            invalidate_selected_counts();
+            invalidate_layout();
             validate_indices();
             return true;
         }
@@ -104,6 +135,8 @@ namespace tui {
 
         if (it != sections_.end()) {
             sections_.erase(it);
+            invalidate_selected_counts();
+            invalidate_layout();
             validate_indices();
             return true;
         }
@@ -115,7 +148,11 @@ namespace tui {
         current_section_index_ = 0;
         current_selection_index_ = 0;
         current_page_ = 0;
+        section_offset_ = 0;
+        item_offset_ = 0;
         current_state_ = NavigationState::MAIN_MENU;
+        invalidate_selected_counts();
+        invalidate_layout();
     }
 
     void NavigationTUI::set_section_selected_callback(SectionSelectedCallback callback) {
@@ -142,7 +179,23 @@ namespace tui {
 
     void NavigationTUI::set_update_callback(UpdateCallback callback) { update_callback_ = std::move(callback); }
 
-    void NavigationTUI::refresh_items() { needs_redraw_ = true; }
+    void NavigationTUI::set_frame_callback(FrameCallback callback) {
+        on_frame_ = std::move(callback);
+        if (on_frame_) {
+            enable_render_stats(true);
+        }
+    }
+
+    void NavigationTUI::enable_render_stats(const bool enable) {
+        render_stats_enabled_ = enable;
+        input_time_.reset();
+    }
+
+    void NavigationTUI::set_terminal_backend(std::shared_ptr<TerminalBackend> backend) {
+        terminal_manager_ = std::make_unique<TerminalManager>(std::move(backend));
+    }
+
+    void NavigationTUI::refresh_items() { invalidate_screen(); }
 
     void NavigationTUI::run() {
         if (sections_.empty()) {
@@ -153,25 +206,105 @@ namespace tui {
         initialize();
         running_ = true;
 
+        using Clock = FrameScheduler::Clock;
+        constexpr auto update_interval = std::chrono::milliseconds(50);
+        constexpr int poll_timeout_ms = 100; ///< Backends that cannot report resizes are polled this often
+        const auto resize_debounce = std::chrono::milliseconds(config_.layout.resize_debounce_ms);
+        const bool event_driven = TerminalManager::event_driven();
+        int terminate_signal = 0;
+
+        scheduler_ = FrameScheduler{};
+        scheduler_.set_frame_rate(config_.layout.frame_rate_limit);
+        scheduler_.request(FrameScheduler::Source::INPUT, Clock::now());
+        Clock::time_point next_update = Clock::now();
+        Clock::time_point next_size_poll = Clock::now() + std::chrono::milliseconds(poll_timeout_ms);
+        std::optional<Clock::time_point> resize_due; ///< Trailing edge of a burst of resizes
+
+        const auto milliseconds_until = [](const Clock::time_point when, const Clock::time_point now) {
+            return static_cast<int>(
+                std::max<int64_t>(0, std::chrono::ceil<std::chrono::milliseconds>(when - now).count()));
+        };
+
         while (running_) {
-            if (needs_redraw_) {
+            // One relayout once a window drag has been quiet for the debounce interval
+            if (resize_due && Clock::now() >= *resize_due) {
+                resize_due.reset();
+                check_terminal_size();
+                if (has_pending_changes()) {
+                    scheduler_.request(FrameScheduler::Source::INPUT, Clock::now());
+                }
+            }
+
+            if (update_callback_ && Clock::now() >= next_update) {
+                update_callback_();
+                next_update = Clock::now() + update_interval;
+                if (has_pending_changes()) {
+                    scheduler_.request(FrameScheduler::Source::TIMER, Clock::now());
+                }
+            }
+
+            if (scheduler_.due(Clock::now())) {
                 render();
-                needs_redraw_ = false;
+                scheduler_.frame_drawn(Clock::now());
             }
 
+            // Sleep until something happens, the pending frame or resize is due or the update callback is next
+            const Clock::time_point now = Clock::now();
+            int timeout_ms = event_driven ? -1 : milliseconds_until(next_size_poll, now);
+            const auto wake_by = [&timeout_ms](const int milliseconds) {
+                timeout_ms = timeout_ms < 0 ? milliseconds : std::min(timeout_ms, milliseconds);
+            };
             if (update_callback_) {
-                update_callback_();
+                wake_by(milliseconds_until(next_update, now));
+            }
+            if (resize_due) {
+                wake_by(milliseconds_until(*resize_due, now));
+            }
+            if (const int until_frame = scheduler_.milliseconds_until_due(now); until_frame >= 0) {
+                wake_by(until_frame);
             }
 
-            int timeout_ms = (update_callback_ != nullptr) ? 50 : 100;
+            const WaitResult woke = TerminalManager::wait(timeout_ms);
+            if (woke.terminate_signal != 0) {
+                terminate_signal = woke.terminate_signal;
+                break;
+            }
 
-            if (TerminalManager::wait_for_input(timeout_ms)) {
+            if (woke.woken || wake_requested_.exchange(false)) {
+                // Another thread changed what is shown
+                next_update = Clock::now();
+                invalidate_selected_counts();
+                invalidate_layout();
+                needs_redraw_ = true;
+            }
+            if (woke.resized) {
+                // Every SIGWINCH of a drag pushes the relayout back, the size in between is never drawn
+                if (resize_debounce.count() > 0) {
+                    resize_due = Clock::now() + resize_debounce;
+                } else {
+                    check_terminal_size();
+                }
+            } else if (!event_driven && Clock::now() >= next_size_poll) {
+                next_size_poll = Clock::now() + std::chrono::milliseconds(poll_timeout_ms);
+                check_terminal_size();
+            }
+            if (woke.input) {
                 process_events();
             }
+            if (has_pending_changes()) {
+                scheduler_.request(FrameScheduler::Source::INPUT, Clock::now());
+            }
         }
 
         terminal_manager_->restore_terminal();
 
+        // SIGTERM / SIGINT: the terminal is usable again, now let the signal do what it would have done
+        if (terminate_signal != 0) {
+            running_ = false;
+            std::raise(terminate_signal);
+            return;
+        }
+
         if (on_exit_) {
             on_exit_(sections_);
         }
@@ -183,19 +316,23 @@ namespace tui {
         // std::cin.clear();
     }
 
+    void NavigationTUI::wake() {
+        wake_requested_ = true;
+        TerminalManager::wake();
+    }
+
     NavigationTUI::NavigationState NavigationTUI::get_current_state() const { return current_state_; }
 
     size_t NavigationTUI::get_current_section_index() const { return current_section_index_; }
 
-    int NavigationTUI::get_current_page() const { return current_page_; }
+    int NavigationTUI::get_current_page() const { return get_viewport_page(NavigationState::ITEM_SELECTION); }
 
     size_t NavigationTUI::get_current_selection_index() const { return current_selection_index_; }
 
     void NavigationTUI::return_to_sections() {
         if (current_state_ != NavigationState::MAIN_MENU) {
             change_state(NavigationState::MAIN_MENU);
-            current_selection_index_ = static_cast<int>(current_section_index_) % config_.layout.sections_per_page;
-            current_section_page_ = static_cast<int>(current_section_index_) / config_.layout.sections_per_page;
+            show_entry(current_section_index_);
             needs_redraw_ = true;
         }
     }
@@ -205,7 +342,9 @@ namespace tui {
             current_section_index_ = section_index;
             current_selection_index_ = 0;
             current_page_ = 0;
+            item_offset_ = 0;
             change_state(NavigationState::ITEM_SELECTION);
+            invalidate_layout();
 
             const auto& section = sections_[section_index];
             section.trigger_enter();
@@ -214,30 +353,51 @@ namespace tui {
                 on_section_selected_(section_index, section);
             }
 
+            if (section.on_enter || on_section_selected_) {
+                invalidate_screen();
+            }
             needs_redraw_ = true;
         }
     }
 
     int NavigationTUI::get_sections_on_current_page() const {
-        const int start = current_section_page_ * config_.layout.sections_per_page;
-        const int end = std::min(start + config_.layout.sections_per_page, static_cast<int>(sections_.size()));
-        return end - start;
+        const size_t start = std::min(get_list_offset(NavigationState::MAIN_MENU), sections_.size());
+        return static_cast<int>(std::min(get_viewport_rows(NavigationState::MAIN_MENU), sections_.size() - start));
     }
 
     void NavigationTUI::go_to_section_page(const int page) {
-        if (const int total_pages = calculate_total_pages();
+        constexpr auto state = NavigationState::MAIN_MENU;
+        if (config_.layout.scroll_lists) {
+            if (page >= 0 && page < calculate_total_pages(state)) {
+                scroll_to(state, static_cast<size_t>(page) * get_viewport_rows(state));
+            }
+            return;
+        }
+
+        if (const int total_pages = calculate_total_pages(state);
             page >= 0 && page < total_pages && page != current_section_page_) {
             current_section_page_ = page;
+            invalidate_layout();
             needs_redraw_ = true;
         }
     }
 
     void NavigationTUI::go_to_page(const int page) {
-        if (const int total_pages = calculate_total_pages(); page >= 0 && page < total_pages && page != current_page_) {
+        constexpr auto state = NavigationState::ITEM_SELECTION;
+        if (config_.layout.scroll_lists) {
+            if (page >= 0 && page < calculate_total_pages(state)) {
+                scroll_to(state, static_cast<size_t>(page) * get_viewport_rows(state));
+            }
+            return;
+        }
+
+        if (const int total_pages = calculate_total_pages(state); page >= 0 && page < total_pages && page != current_page_) {
             current_page_ = page;
+            invalidate_layout();
 
             if (on_page_changed_) {
                 on_page_changed_(page, total_pages);
+                invalidate_screen();
             }
 
             needs_redraw_ = true;
@@ -245,7 +405,9 @@ namespace tui {
     }
 
     void NavigationTUI::next_page() {
-        if (current_state_ == NavigationState::MAIN_MENU) {
+        if (config_.layout.scroll_lists) {
+            scroll_to(get_list_offset(current_state_) + get_viewport_rows(current_state_));
+        } else if (current_state_ == NavigationState::MAIN_MENU) {
             go_to_section_page(current_section_page_ + 1);
         } else if (current_state_ == NavigationState::ITEM_SELECTION) {
             go_to_page(current_page_ + 1);
@@ -253,7 +415,10 @@ namespace tui {
     }
 
     void NavigationTUI::previous_page() {
-        if (current_state_ == NavigationState::MAIN_MENU) {
+        if (config_.layout.scroll_lists) {
+            const size_t offset = get_list_offset(current_state_);
+            scroll_to(offset - std::min(offset, get_viewport_rows(current_state_)));
+        } else if (current_state_ == NavigationState::MAIN_MENU) {
             go_to_section_page(current_section_page_ - 1);
         } else if (current_state_ == NavigationState::ITEM_SELECTION) {
             go_to_page(current_page_ - 1);
@@ -281,42 +446,58 @@ namespace tui {
         for (auto& section : sections_) {
             section.clear_selections();
         }
+        invalidate_selected_counts();
         needs_redraw_ = true;
     }
 
     void NavigationTUI::clear_section_selections(const size_t section_index) {
         if (section_index < sections_.size()) {
             sections_[section_index].clear_selections();
+            invalidate_selected_counts();
             needs_redraw_ = true;
         }
     }
 
     void NavigationTUI::update_config(const Config& new_config) {
         config_ = new_config;
+        compile_theme();
+        invalidate_layout();
         needs_redraw_ = true;
     }
 
     void NavigationTUI::update_theme(const Theme& new_theme) {
         config_.theme = new_theme;
+        compile_theme();
+        invalidate_layout();
         needs_redraw_ = true;
     }
 
     void NavigationTUI::update_layout(const Layout& new_layout) {
         config_.layout = new_layout;
+        invalidate_layout();
         needs_redraw_ = true;
     }
 
     void NavigationTUI::update_text_config(const TextConfig& new_text_config) {
         config_.text = new_text_config;
+        invalidate_layout();
         needs_redraw_ = true;
     }
 
     const NavigationTUI::Config& NavigationTUI::get_config() const { return config_; }
 
     void NavigationTUI::initialize() {
-        terminal_manager_->setup_terminal();
+        terminal_manager_->setup_terminal(config_.layout.use_alternate_screen);
+        TerminalManager::set_escape_timeout(config_.escape_timeout_ms);
+        if (const ColorDepth depth = TerminalUtils::color_depth(); depth != color_depth_) {
+            color_depth_ = depth;
+            compile_theme();
+        }
+        screen_.invalidate();
+        invalidate_layout();
         validate_indices();
 
+        // init_terminal() just measured the terminal
         auto [t_height, t_width] = TerminalManager::get_terminal_size();
         previous_width_ = t_width;
         previous_height_ = t_height;
@@ -324,17 +505,58 @@ namespace tui {
         needs_redraw_ = true;
     }
 
-    void NavigationTUI::process_events() {
-        if (auto [t_height, t_width] = TerminalManager::get_terminal_size();
+    void NavigationTUI::check_terminal_size() {
+        if (auto [t_height, t_width] = TerminalManager::refresh_terminal_size();
             t_width != previous_width_ || t_height != previous_height_) {
             previous_width_ = t_width;
             previous_height_ = t_height;
+            invalidate_layout();
+
+            // The viewport follows the terminal height, keep the cursor inside it
+            if (config_.layout.scroll_lists && get_list_size(current_state_) > 0) {
+                show_entry(get_list_offset(current_state_) + current_selection_index_);
+            }
             needs_redraw_ = true;
         }
+    }
 
-        // Process all pending input
+    void NavigationTUI::process_events() {
+        // Drain all pending input first, so repeated keys can be folded
+        pending_keys_.clear();
         while (auto key_event = TerminalManager::get_key_input()) {
-            handle_input(key_event->key, key_event->character);
+            if (render_stats_active() && !input_time_) {
+                input_time_ = ScopedPhase::Clock::now();
+            }
+            pending_keys_.push_back(*key_event);
+        }
+
+        // A held arrow key queues up faster than single steps are handled, a run of the same
+        // key becomes one move (one scroll, one page change callback). A custom command handler
+        // sees every key, so nothing is folded while one is installed.
+        const bool fold = !on_custom_command_;
+        for (size_t i = 0; i < pending_keys_.size();) {
+            const Key key = pending_keys_[i].key;
+            size_t run = 1;
+            if (fold && (key == Key::ARROW_UP || key == Key::ARROW_DOWN || key == Key::ARROW_LEFT ||
+                         key == Key::ARROW_RIGHT)) {
+                while (i + run < pending_keys_.size() && pending_keys_[i + run].key == key) {
+                    ++run;
+                }
+            }
+
+            if (run == 1) {
+                // Ctrl or Alt with a letter is not the letter's command
+                const KeyEvent& event = pending_keys_[i];
+                const bool chord = key == Key::NORMAL && (event.has(KeyModifier::CTRL) || event.has(KeyModifier::ALT));
+                handle_input(chord ? Key::UNKNOWN : key, chord ? '\0' : event.character);
+            } else if (key == Key::ARROW_UP || key == Key::ARROW_DOWN) {
+                const auto rows = static_cast<std::ptrdiff_t>(run);
+                move_selection_by(key == Key::ARROW_DOWN ? rows : -rows);
+            } else {
+                const int pages = static_cast<int>(std::min<size_t>(run, std::numeric_limits<int>::max()));
+                turn_pages(key == Key::ARROW_RIGHT ? pages : -pages);
+            }
+            i += run;
         }
     }
 
@@ -347,6 +569,7 @@ namespace tui {
 
         // Custom keybindings
         if (on_custom_command_ && on_custom_command_(character, current_state_)) {
+            invalidate_screen();
             return;
         }
 
@@ -395,12 +618,12 @@ namespace tui {
                 } else if (character == 'a') {
                     if (current_section_index_ < sections_.size()) {
                         sections_[current_section_index_].select_all();
-                        needs_redraw_ = true;
+                        invalidate_screen();
                     }
                 } else if (character == 'n') {
                     if (current_section_index_ < sections_.size()) {
                         sections_[current_section_index_].clear_selections();
-                        needs_redraw_ = true;
+                        invalidate_screen();
                     }
                 }
             } else if (current_state_ == NavigationState::MAIN_MENU && std::isdigit(character)) {
@@ -423,7 +646,15 @@ namespace tui {
     }
 
     void NavigationTUI::move_selection_up() {
-        if (current_state_ == NavigationState::MAIN_MENU) {
+        const size_t previous_selection = current_selection_index_;
+
+        if (config_.layout.scroll_lists) {
+            if (current_selection_index_ > 0) {
+                current_selection_index_--;
+            } else if (const size_t offset = get_list_offset(current_state_); offset > 0) {
+                scroll_to(offset - 1);
+            }
+        } else if (current_state_ == NavigationState::MAIN_MENU) {
             if (current_selection_index_ > 0) {
                 current_selection_index_--;
             } else if (current_section_page_ > 0) {
@@ -441,11 +672,28 @@ namespace tui {
                 }
             }
         }
-        needs_redraw_ = true;
+
+        // A page change already requested a full frame
+        if (!needs_redraw_ && current_selection_index_ != previous_selection) {
+            mark_row_dirty(previous_selection);
+            mark_row_dirty(current_selection_index_);
+        }
     }
 
     void NavigationTUI::move_selection_down() {
-        if (current_state_ == NavigationState::MAIN_MENU) {
+        const size_t previous_selection = current_selection_index_;
+
+        if (config_.layout.scroll_lists) {
+            const size_t size = get_list_size(current_state_);
+            const size_t offset = std::min(get_list_offset(current_state_), size);
+            const size_t visible = std::min(get_viewport_rows(current_state_), size - offset);
+
+            if (current_selection_index_ + 1 < visible) {
+                current_selection_index_++;
+            } else if (offset + visible < size) {
+                scroll_to(offset + 1);
+            }
+        } else if (current_state_ == NavigationState::MAIN_MENU) {
             const int items_on_page = get_sections_on_current_page();
             const int total_pages = calculate_total_pages();
 
@@ -468,12 +716,81 @@ namespace tui {
             }
         }
 
-        needs_redraw_ = true;
+        if (!needs_redraw_ && current_selection_index_ != previous_selection) {
+            mark_row_dirty(previous_selection);
+            mark_row_dirty(current_selection_index_);
+        }
+    }
+
+    void NavigationTUI::move_selection_by(const std::ptrdiff_t rows) {
+        const size_t size = get_list_size(current_state_);
+        if (rows == 0 || size == 0) {
+            return;
+        }
+
+        const size_t previous_selection = current_selection_index_;
+        const size_t viewport = get_viewport_rows(current_state_);
+        const size_t offset = get_list_offset(current_state_);
+        const size_t current = offset + current_selection_index_;
+
+        // Single steps stop at the last page they can reach, with unpaginated sections that is the first one.
+        // A selection left past the end of a short last page only moves up, like it does one step at a time.
+        const size_t last = config_.layout.scroll_lists
+            ? size - 1
+            : std::min(size, static_cast<size_t>(calculate_total_pages()) * viewport) - 1;
+        const auto distance = static_cast<size_t>(std::abs(rows));
+        size_t target = current;
+        if (rows < 0) {
+            target -= std::min(current, distance);
+        } else if (current < last) {
+            target = std::min(last, current + distance);
+        }
+
+        if (config_.layout.scroll_lists) {
+            // The cursor walks to the edge of the viewport, then the list scrolls under it
+            if (target < offset) {
+                scroll_to(target);
+            } else if (target >= offset + viewport) {
+                scroll_to(target - viewport + 1);
+            }
+            current_selection_index_ = target - get_list_offset(current_state_);
+        } else {
+            const auto page = static_cast<int>(target / viewport);
+            if (current_state_ == NavigationState::MAIN_MENU) {
+                go_to_section_page(page);
+            } else {
+                go_to_page(page);
+            }
+            current_selection_index_ = target % viewport;
+        }
+
+        if (!needs_redraw_ && current_selection_index_ != previous_selection) {
+            mark_row_dirty(previous_selection);
+            mark_row_dirty(current_selection_index_);
+        }
+    }
+
+    void NavigationTUI::turn_pages(const int pages) {
+        if (config_.layout.scroll_lists) {
+            const size_t offset = get_list_offset(current_state_);
+            const size_t distance = static_cast<size_t>(std::abs(pages)) * get_viewport_rows(current_state_);
+            scroll_to(pages < 0 ? offset - std::min(offset, distance) : offset + distance);
+            return;
+        }
+
+        const int current = current_state_ == NavigationState::MAIN_MENU ? current_section_page_ : current_page_;
+        const int page = static_cast<int>(
+            std::clamp(static_cast<int64_t>(current) + pages, int64_t{0}, int64_t{calculate_total_pages() - 1}));
+        if (current_state_ == NavigationState::MAIN_MENU) {
+            go_to_section_page(page);
+        } else if (current_state_ == NavigationState::ITEM_SELECTION) {
+            go_to_page(page);
+        }
     }
 
     void NavigationTUI::select_current_item() {
         if (current_state_ == NavigationState::MAIN_MENU) {
-            size_t global_index = current_section_page_ * config_.layout.sections_per_page + current_selection_index_;
+            const size_t global_index = get_list_offset(current_state_) + current_selection_index_;
             if (global_index < sections_.size()) {
                 enter_section(global_index);
             }
@@ -488,12 +805,25 @@ namespace tui {
 
             if (const size_t global_index = start + current_selection_index_;
                 sections_[current_section_index_].toggle_item(global_index)) {
-                if (on_item_toggled_) {
-                    if (const auto* item = sections_[current_section_index_].get_item(global_index)) {
-                        on_item_toggled_(current_section_index_, global_index, item->selected);
+                const auto& section = sections_[current_section_index_];
+                const auto* item = section.get_item(global_index);
+
+                if (on_item_toggled_ && item) {
+                    on_item_toggled_(current_section_index_, global_index, item->selected);
+                }
+
+                // Callbacks may have printed over the screen
+                if (on_item_toggled_ || section.on_item_toggled || (item && item->on_toggle)) {
+                    invalidate_screen();
+                } else {
+                    // Keep the cached counter in step instead of recounting the section
+                    if (current_section_index_ < selected_counts_.size() && item) {
+                        if (size_t& count = selected_counts_[current_section_index_]; count != std::string::npos) {
+                            count = item->selected ? count + 1 : count - 1;
+                        }
                     }
+                    mark_row_dirty(current_selection_index_);
                 }
-                needs_redraw_ = true;
             }
         }
     }
@@ -503,11 +833,9 @@ namespace tui {
 
         if (current_state_ == NavigationState::MAIN_MENU) {
             if (number > 0 && number <= static_cast<int>(sections_.size())) {
-                const auto global_index = number - 1;
-
-                current_section_page_ = global_index / config_.layout.sections_per_page;
-                current_selection_index_ = global_index % config_.layout.sections_per_page;
+                const auto global_index = static_cast<size_t>(number - 1);
 
+                show_entry(global_index);
                 enter_section(global_index);
             } else if (config_.layout.paginate_sections && number > 0 && number <= calculate_total_pages()) {
                 go_to_section_page(number - 1);
@@ -531,15 +859,8 @@ namespace tui {
         return content_width;
     }
 
-    int NavigationTUI::get_effective_content_height() const {
-        auto content_height = 0;
-
-        if (current_state_ == NavigationState::MAIN_MENU) {
-            content_height = 3 + static_cast<int>(sections_.size()) + 2;
-        } else if (current_section_index_ < sections_.size()) {
-            auto [first, second] = get_current_page_bounds();
-            content_height = 3 + static_cast<int>((second - first)) + 2;
-        }
+    int NavigationTUI::get_effective_content_height(const size_t row_count) const {
+        auto content_height = 3 + static_cast<int>(row_count) + 2;
 
         content_height += 2 * config_.layout.vertical_padding;
 
@@ -550,81 +871,181 @@ namespace tui {
         return content_height;
     }
 
-    void NavigationTUI::draw_border(int top, int left, int width, int height) const {
-        std::string top_left, top_right, bottom_left, bottom_right, horizontal, vertical;
+    void NavigationTUI::compile_theme() {
+        const auto& theme = config_.theme;
+        theme_ = CompiledTheme{};
+
+        const auto role = [&theme, depth = color_depth_](const extras::Color& color) {
+            return theme.use_colors ? CompiledTheme::Role{downsample(CellStyle::from_color(color), depth),
+                                                          get_color_sequence(color, depth)}
+                                    : CompiledTheme::Role{};
+        };
+        theme_.border = role(theme.palette.border);
+        theme_.header_text = role(theme.palette.header_text);
+        theme_.header_border = role(theme.palette.header_border);
+        theme_.selected_item = role(theme.palette.selected_item);
+        theme_.unselected_item = role(theme.palette.unselected_item);
 
-        switch (config_.theme.border_style) {
+        switch (theme.border_style) {
         case extras::BorderStyle::ROUNDED:
-            top_left = "╭";
-            top_right = "╮";
-            bottom_left = "╰";
-            bottom_right = "╯";
-            horizontal = "─";
-            vertical = "│";
+            theme_.top_left = "╭";
+            theme_.top_right = "╮";
+            theme_.bottom_left = "╰";
+            theme_.bottom_right = "╯";
+            border_horizontal_ = "─";
+            theme_.vertical = "│";
             break;
         case extras::BorderStyle::DOUBLE:
-            top_left = "╔";
-            top_right = "╗";
-            bottom_left = "╚";
-            bottom_right = "╝";
-            horizontal = "═";
-            vertical = "║";
+            theme_.top_left = "╔";
+            theme_.top_right = "╗";
+            theme_.bottom_left = "╚";
+            theme_.bottom_right = "╝";
+            border_horizontal_ = "═";
+            theme_.vertical = "║";
             break;
         case extras::BorderStyle::SHARP:
-            top_left = "┌";
-            top_right = "┐";
-            bottom_left = "└";
-            bottom_right = "┘";
-            horizontal = "─";
-            vertical = "│";
+            theme_.top_left = "┌";
+            theme_.top_right = "┐";
+            theme_.bottom_left = "└";
+            theme_.bottom_right = "┘";
+            border_horizontal_ = "─";
+            theme_.vertical = "│";
             break;
         case extras::BorderStyle::ASCII:
         default:
-            top_left = "+";
-            top_right = "+";
-            bottom_left = "+";
-            bottom_right = "+";
-            horizontal = "-";
-            vertical = "|";
+            theme_.top_left = "+";
+            theme_.top_right = "+";
+            theme_.bottom_left = "+";
+            theme_.bottom_right = "+";
+            border_horizontal_ = "-";
+            theme_.vertical = "|";
             break;
         }
 
-        if (config_.theme.use_colors) {
-            fmt::print("{}", get_color_sequence(config_.theme.palette.border));
-        }
+        theme_.selected_prefix = theme.selected_prefix;
+        theme_.unselected_prefix = theme.unselected_prefix;
+        theme_.highlighted_prefix = theme.highlighted_prefix;
+        theme_.selected_prefix_width = TerminalUtils::get_visible_string_length(theme.selected_prefix);
+        theme_.unselected_prefix_width = TerminalUtils::get_visible_string_length(theme.unselected_prefix);
+        theme_.highlight_width = TerminalUtils::get_visible_string_length(theme.highlighted_prefix);
+        theme_.highlight_padding.assign(theme_.highlight_width, ' ');
+    }
 
-        TerminalUtils::move_cursor(top, left);
-        fmt::print("{}", top_left);
-        for (auto i = 0; i < width - 2; ++i) {
-            fmt::print("{}", horizontal);
-        }
-        fmt::print("{}", top_right);
+    void NavigationTUI::draw_border(const int top, const int left, const int width, const int height) {
+        // The edges only depend on the width, rebuild them when the content area changes size
+        if (theme_.edge_width != width) {
+            std::string horizontal_run;
+            horizontal_run.reserve(border_horizontal_.size() * static_cast<size_t>(std::max(0, width - 2)));
+            for (auto i = 0; i < width - 2; ++i) {
+                horizontal_run += border_horizontal_;
+            }
 
-        for (int y = top + 1; y < top + height - 1; ++y) {
-            TerminalUtils::move_cursor(y, left);
-            fmt::print("{}", vertical);
-            TerminalUtils::move_cursor(y, left + width - 1);
-            fmt::print("{}", vertical);
+            theme_.top_edge = theme_.top_left + horizontal_run + theme_.top_right;
+            theme_.bottom_edge = theme_.bottom_left + horizontal_run + theme_.bottom_right;
+            theme_.edge_width = width;
         }
 
-        TerminalUtils::move_cursor(top + height - 1, left);
-        fmt::print("{}", bottom_left);
-        for (int i = 0; i < width - 2; ++i) {
-            fmt::print("{}", horizontal);
+        const CellStyle& style = theme_.border.style;
+        screen_.draw_text(top, left, theme_.top_edge, style);
+
+        for (int y = top + 1; y < top + height - 1; ++y) {
+            screen_.draw_text(y, left, theme_.vertical, style);
+            screen_.draw_text(y, left + width - 1, theme_.vertical, style);
         }
-        fmt::print("{}", bottom_right);
 
-        TerminalUtils::reset_formatting();
+        screen_.draw_text(top + height - 1, left, theme_.bottom_edge, style);
     }
 
     void NavigationTUI::render() {
-        if (!needs_redraw_) {
+        if (!has_pending_changes()) {
+            if (render_stats_active()) {
+                render_stats_.record_skipped();
+            }
             return;
         }
 
-        TerminalManager::clear_screen();
+        const bool measure = render_stats_active();
+        frame_stats_ = FrameStats{};
+        {
+            ScopedPhase format(measure, frame_stats_.format);
+
+            if (needs_redraw_ || !render_dirty_rows()) {
+                // Let the terminal move the list rows that stay visible, the diff then only fills in the exposed ones
+                if (pending_scroll_ != 0 && !frame_.row_widths.empty()) {
+                    screen_.scroll(frame_.items_row,
+                                   frame_.items_row + static_cast<int>(frame_.row_widths.size()) - 1, pending_scroll_);
+                }
+                render_full_frame();
+                frame_stats_.full_frame = true;
+            }
+        }
+
+        {
+            ScopedPhase emit(measure, frame_stats_.emit);
+            TerminalUtils::begin_synchronized_update();
+            screen_.flush();
+            TerminalUtils::end_synchronized_update();
+        }
+
+        {
+            const auto& output = TerminalUtils::output();
+            frame_stats_.bytes = output.size();
+            const uint64_t writes = output.total_writes();
+
+            ScopedPhase flush(measure, frame_stats_.flush);
+            TerminalManager::flush_output();
+            frame_stats_.writes = static_cast<size_t>(output.total_writes() - writes);
+        }
+
+        if (measure) {
+            finish_frame_stats();
+        }
+
+        dirty_rows_.clear();
+        footer_dirty_ = false;
+        needs_redraw_ = false;
+        pending_scroll_ = 0;
+    }
+
+    void NavigationTUI::finish_frame_stats() {
+        // The layout ran inside the format phase
+        frame_stats_.format -= frame_stats_.layout;
+        frame_stats_.total = frame_stats_.layout + frame_stats_.format + frame_stats_.emit + frame_stats_.flush;
+
+        if (input_time_) {
+            frame_stats_.input_latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                ScopedPhase::Clock::now() - *input_time_);
+            input_time_.reset();
+        }
+
+        render_stats_.record(frame_stats_);
+        if (on_frame_) {
+            on_frame_(frame_stats_);
+        }
+    }
+
+    void NavigationTUI::mark_row_dirty(const size_t row) {
+        if (std::find(dirty_rows_.begin(), dirty_rows_.end(), row) == dirty_rows_.end()) {
+            dirty_rows_.push_back(row);
+        }
+        // The footer describes the highlighted row
+        footer_dirty_ = true;
+    }
+
+    void NavigationTUI::invalidate_screen() {
+        screen_.invalidate();
+        invalidate_selected_counts();
+        invalidate_layout();
+        needs_redraw_ = true;
+    }
+
+    void NavigationTUI::compute_layout() {
+        layout_ = LayoutState{};
 
         auto [term_height, term_width] = TerminalManager::get_terminal_size();
+        layout_.term_height = term_height;
+        layout_.term_width = term_width;
+
         int content_width = get_effective_content_width(term_width);
         auto left_padding = 1;
 
@@ -632,70 +1053,165 @@ namespace tui {
             left_padding = (term_width - content_width) / 2;
         }
 
-        auto start_row = 1;
-        if (config_.layout.center_vertically) {
-            const int content_height = get_effective_content_height();
-            start_row = std::max(1, (term_height - content_height) / 2);
-        }
-
         if (config_.layout.show_borders) {
             content_width = std::max(10, content_width - 2);
 
             left_padding = std::max(1, left_padding - 1);
-            start_row = std::max(1, start_row - 1);
+
+            layout_.border = true;
+            layout_.border_left = left_padding;
+            layout_.border_width = content_width + 2;
+
+            left_padding += 1;
         }
 
-        if (config_.layout.show_borders) {
-            auto content_height = 0;
+        layout_.content_width = content_width;
+        layout_.left_padding = left_padding;
 
-            if (current_state_ == NavigationState::MAIN_MENU) {
-                content_height = 3 + static_cast<int>(sections_.size()) + 2;
-            } else if (current_section_index_ < sections_.size()) {
-                auto [first, second] = get_current_page_bounds();
-                content_height = 3 + static_cast<int>((second - first)) + 2;
-            }
+        // The footer wraps to the content width, its height decides how many list rows fit above it
+        const auto [description_lines, help_lines] = get_footer_lines(content_width, get_current_item());
+        layout_.description_lines = description_lines;
+        layout_.help_lines = help_lines;
+        footer_height_ = description_lines + 1 + help_lines + 2;
 
-            content_height += 2 * config_.layout.vertical_padding;
-            draw_border(start_row, left_padding, content_width + 2, content_height + 2);
+        if (config_.layout.scroll_lists && get_list_size(current_state_) > 0 &&
+            current_selection_index_ >= get_viewport_rows(current_state_)) {
+            show_entry(get_list_offset(current_state_) + current_selection_index_);
+        }
 
-            left_padding += 1;
-            start_row += 1;
+        if (current_state_ == NavigationState::MAIN_MENU) {
+            layout_.row_count = static_cast<size_t>(std::max(0, get_sections_on_current_page()));
+        } else if (current_section_index_ < sections_.size()) {
+            auto [first, second] = get_current_page_bounds();
+            layout_.row_count = second - first;
+        }
+
+        layout_.footer_top = term_height - footer_height_ + 1;
+        place_content(layout_);
+
+        // Pages taller than the terminal push the footer down rather than drawing over the list
+        layout_.footer_top = std::max(layout_.footer_top, layout_.content_bottom + 1);
+        layout_.description_row = layout_.footer_top;
+        layout_.help_row = layout_.description_row + description_lines + 1;
+
+        for (size_t i = 0; i < layout_.row_count; ++i) {
+            layout_.max_row_width = std::max(layout_.max_row_width, build_list_row(i).width);
+        }
+
+        const auto max_width = static_cast<int>(layout_.max_row_width);
+        const int block_offset = (config_.layout.center_horizontally && content_width > max_width)
+            ? (content_width - max_width) / 2
+            : 0;
+        layout_.items_col = left_padding + block_offset;
+
+        layout_.valid = true;
+    }
+
+    void NavigationTUI::place_content(LayoutState& layout) const {
+        const int padding = config_.layout.vertical_padding;
+        const int border = config_.layout.show_borders ? 1 : 0;
+
+        // Rows from the top border (or the padding above the title) down to the bottom border (or the last list row)
+        const int height = 2 + 2 * padding + static_cast<int>(layout.row_count) + 5 * border;
+
+        auto top = 1;
+        if (config_.layout.center_vertically) {
+            top = (layout.term_height - get_effective_content_height(layout.row_count)) / 2 - border;
         }
+        top = std::max(1, std::min(top, layout.footer_top - height));
+
+        if (border) {
+            layout.border_top = top;
+            layout.border_height = height;
+        }
+        layout.header_row = top + border + padding;
+        layout.items_row = layout.header_row + 2 + padding;
+        layout.content_bottom = top + height - 1;
+    }
+
+    void NavigationTUI::render_full_frame() {
+        if (!layout_.valid) {
+            ScopedPhase layout(render_stats_active(), frame_stats_.layout);
+            compute_layout();
+        }
+
+        screen_.resize(layout_.term_height, layout_.term_width);
+        screen_.clear();
 
-        start_row += config_.layout.vertical_padding;
+        frame_ = FrameGeometry{};
+
+        if (layout_.border) {
+            draw_border(layout_.border_top, layout_.border_left, layout_.border_width, layout_.border_height);
+            frame_.content_bottom = layout_.border_top + layout_.border_height - 1;
+        }
 
         if (current_state_ == NavigationState::MAIN_MENU) {
-            render_section_selection(start_row, left_padding, content_width);
+            render_section_selection(layout_.header_row, layout_.left_padding, layout_.content_width);
         } else {
-            render_item_selection(start_row, left_padding, content_width);
+            render_item_selection(layout_.header_row, layout_.left_padding, layout_.content_width);
         }
 
-        const SelectableItem* current_item = nullptr;
-        if (current_state_ == NavigationState::ITEM_SELECTION && current_section_index_ < sections_.size()) {
-            const auto& section = sections_[current_section_index_];
+        frame_.content_bottom =
+            std::max(frame_.content_bottom, frame_.items_row + static_cast<int>(frame_.row_widths.size()) - 1);
+
+        render_footer(layout_.left_padding, layout_.content_width, get_current_item());
+    }
+
+    bool NavigationTUI::render_dirty_rows() {
+        if (!layout_.valid || layout_.term_height != screen_.rows()) {
+            return false;
+        }
+
+        // Format every damaged row first so a width change can still fall back to a full frame
+        std::vector<std::pair<size_t, ListRow>> rows;
+        rows.reserve(dirty_rows_.size());
+
+        for (const size_t row : dirty_rows_) {
+            if (row >= frame_.row_widths.size()) {
+                return false;
+            }
 
-            if (auto [first, second] = get_current_page_bounds(); current_selection_index_ < (second - first)) {
-                const size_t global_index = first + current_selection_index_;
-                current_item = section.get_item(global_index);
+            ListRow data = build_list_row(row);
+            if (data.width != frame_.row_widths[row]) {
+                // The widest row decides where the list block sits
+                invalidate_layout();
+                return false;
             }
+            rows.emplace_back(row, std::move(data));
         }
 
-        render_footer(term_height, left_padding, content_width, current_item);
-        TerminalManager::flush_output();
+        if (footer_dirty_) {
+            // A footer of a different height moves the viewport and the border
+            if (get_footer_lines(layout_.content_width, get_current_item()) !=
+                std::pair{layout_.description_lines, layout_.help_lines}) {
+                invalidate_layout();
+                return false;
+            }
 
-        needs_redraw_ = false;
+            for (int row = frame_.footer_top; row <= layout_.term_height; ++row) {
+                screen_.clear_line(row);
+            }
+            render_footer(layout_.left_padding, layout_.content_width, get_current_item());
+        }
+
+        for (const auto& [row, data] : rows) {
+            draw_list_row(frame_.items_row + static_cast<int>(row), layout_.items_col, data);
+        }
+
+        return true;
     }
 
     void NavigationTUI::render_header(int /*term_width*/, const int content_width, const std::string& title) {
         const std::string centered_title = center_string(title, content_width).content;
-        const std::string separator = center_string(std::string(title.length(), '='), content_width).content;
+        const std::string separator =
+            center_string(std::string(TerminalUtils::get_visible_string_length(title), '='), content_width).content;
 
         if (config_.theme.use_colors) {
-            fmt::print("{}", get_color_sequence(config_.theme.palette.header_text) + centered_title);
+            fmt::print("{}{}", theme_.header_text.sgr, centered_title);
             TerminalUtils::reset_formatting();
             fmt::println(""); // Newline from println
 
-            fmt::print("{}", get_color_sequence(config_.theme.palette.header_border) + separator);
+            fmt::print("{}{}", theme_.header_border.sgr, separator);
             TerminalUtils::reset_formatting();
             fmt::println("");
         } else {
@@ -704,124 +1220,150 @@ namespace tui {
         }
     }
 
-    void NavigationTUI::apply_gradient_text(const std::string& text, const int row, const int col) const {
+    void NavigationTUI::apply_gradient_text(const std::string& text, const int row, const int col) {
         if (!config_.theme.gradient_enabled || text.empty()) {
             return;
         }
 
         const size_t visible_len = TerminalUtils::get_visible_string_length(text);
         if (visible_len == 0) {
-            TerminalUtils::move_cursor(row, col);
-            fmt::print("{}", text);
             return;
         }
 
-        auto gradient =
-            extras::GradientColor::from_preset(config_.theme.gradient_preset, static_cast<int>(visible_len));
+        const std::vector<extras::GradientColor>* gradient =
+            &gradient_cache_.get(config_.theme.gradient_preset, static_cast<int>(visible_len));
         if (config_.theme.gradient_randomize) {
+            gradient_scratch_.assign(gradient->begin(), gradient->end());
 #if __cplusplus >= 202002L
-            std::ranges::shuffle(gradient, std::mt19937(std::random_device()()));
+            std::ranges::shuffle(gradient_scratch_, gradient_rng_);
 #else
-            std::shuffle(gradient.begin(), gradient.end(), std::mt19937(std::random_device()()));
+            std::shuffle(gradient_scratch_.begin(), gradient_scratch_.end(), gradient_rng_);
 #endif
+            gradient = &gradient_scratch_;
         }
 
-        TerminalUtils::move_cursor(row, col);
-
+        // Cells sharing a (quantized) color are drawn as one run
+        const std::string_view view(text);
+        int current_col = col;
         size_t gradient_idx = 0;
-        for (size_t i = 0; i < text.length(); ++i) {
-            if (text[i] == '\033') {
-                if (const size_t end_pos = text.find('m', i); end_pos != std::string::npos) {
-                    fmt::print("{}", text.substr(i, end_pos - i + 1));
-                    i = end_pos;
-                } else {
-                    fmt::print("{}", text[i]);
-                }
-            } else {
-                if (gradient_idx < gradient.size()) {
-                    TerminalUtils::set_color_rgb(gradient[gradient_idx++]);
-                }
-                fmt::print("{}", text[i]);
+        size_t run_begin = 0;
+        CellStyle run_style;
+
+        const auto draw_run = [&](const size_t run_end) {
+            if (run_begin < run_end) {
+                current_col =
+                    screen_.draw_text(row, current_col, view.substr(run_begin, run_end - run_begin), run_style);
             }
-        }
+        };
 
-        TerminalUtils::reset_formatting();
-    }
+        for (size_t i = 0; i < view.length();) {
+            if (view[i] == '\033') {
+                // Gradient colors replace any embedded styling
+                draw_run(i);
+                const size_t end_pos = view.find('m', i);
+                i = (end_pos != std::string_view::npos) ? end_pos + 1 : view.length();
+                run_begin = i;
+                continue;
+            }
 
+            // One gradient step per column, combining marks stay in the current run
+            size_t next = i;
+            const int width = unicode::code_point_width(unicode::decode_utf8(view, next));
+            if (width == 0) {
+                i = next;
+                continue;
+            }
 
-    void NavigationTUI::render_section_selection(const int start_row, const int left_padding, const int content_width) {
-        // Header
-        TerminalUtils::move_cursor(start_row, left_padding);
-        fmt::print("{}", center_string(config_.text.section_selection_title, content_width).content);
+            CellStyle style;
+            if (gradient_idx < gradient->size()) {
+                auto [r, g, b] = (*gradient)[gradient_idx].get_color();
+                style = downsample(CellStyle::from_rgb(r, g, b), color_depth_);
+            }
+            gradient_idx += static_cast<size_t>(width);
 
-        TerminalUtils::move_cursor(start_row + 1, left_padding);
-        fmt::print(
-            "{}",
-            center_string(std::string(config_.text.section_selection_title.length(), '='), content_width).content);
+            if (style != run_style) {
+                draw_run(i);
+                run_begin = i;
+                run_style = style;
+            }
+            i = next;
+        }
 
-        // Sections
-        const auto start_index = current_section_page_ * config_.layout.sections_per_page;
-        const auto end_index =
-            std::min(start_index + config_.layout.sections_per_page, static_cast<int>(sections_.size()));
-        const auto items_on_page = end_index - start_index;
-        const int items_start_row = start_row + 2 + config_.layout.vertical_padding;
-
-        const size_t highlight_v_w = TerminalUtils::get_visible_string_length(config_.theme.highlighted_prefix);
-
-        struct SectionItem {
-            std::string base_text;
-            bool is_selected;
-            size_t v_width;
-        };
-        std::vector<SectionItem> items_to_render;
-        size_t max_v_width = 0;
+        draw_run(view.length());
+    }
 
-        for (auto i = 0; i < items_on_page; ++i) {
-            const size_t global_index = start_index + i;
-            const bool is_selected = i == static_cast<int>(current_selection_index_);
+    NavigationTUI::ListRow NavigationTUI::build_list_row(const size_t row) const {
+        ListRow data;
+        data.highlighted = row == current_selection_index_;
 
-            std::string display_text = fmt::format("{}. {}", global_index + 1, sections_[global_index].name);
+        if (current_state_ == NavigationState::MAIN_MENU) {
+            const size_t global_index = get_list_offset(current_state_) + row;
+            const auto& section = sections_[global_index];
+
+            std::string display_text = fmt::format("{}. {}", global_index + 1, section.name);
             if (config_.text.show_counters) {
-                const size_t selected_count = sections_[global_index].get_selected_count();
-                if (const size_t total_count = sections_[global_index].size(); total_count > 0) {
+                const size_t selected_count = get_selected_count(global_index);
+                if (const size_t total_count = section.size(); total_count > 0) {
                     display_text += " (" + std::to_string(selected_count) + "/" + std::to_string(total_count) + ")";
                 }
             }
 
-            const size_t total_v_w = highlight_v_w + TerminalUtils::get_visible_string_length(display_text);
-            if (total_v_w > max_v_width) {
-                max_v_width = total_v_w;
+            data.width = theme_.highlight_width + TerminalUtils::get_visible_string_length(display_text);
+            data.text.reserve(theme_.highlighted_prefix.size() + display_text.size());
+            data.text = data.highlighted ? theme_.highlighted_prefix : theme_.highlight_padding;
+            data.text += display_text;
+        } else {
+            const auto [first, second] = get_current_page_bounds();
+            if (const auto* item = sections_[current_section_index_].get_item(first + row)) {
+                data.text = format_item_with_theme(*item, data.highlighted);
+                data.width = theme_.highlight_width +
+                    (item->selected ? theme_.selected_prefix_width : theme_.unselected_prefix_width) + 1 +
+                    TerminalUtils::get_visible_string_length(item->name);
             }
+        }
+
+        return data;
+    }
 
-            items_to_render.push_back({display_text, is_selected, total_v_w});
+    void NavigationTUI::draw_list_row(const int row, const int col, const ListRow& data) {
+        const bool gradient =
+            config_.theme.gradient_enabled && config_.theme.gradient_preset != extras::GradientPreset::NONE();
+
+        if (data.highlighted && gradient) {
+            apply_gradient_text(data.text, row, col);
+        } else if (data.highlighted && config_.theme.use_colors) {
+            screen_.draw_text(row, col, data.text, theme_.selected_item.style);
+        } else if (!data.highlighted && config_.theme.use_colors && current_state_ == NavigationState::ITEM_SELECTION) {
+            screen_.draw_text(row, col, data.text, theme_.unselected_item.style);
+        } else {
+            screen_.draw_text(row, col, data.text);
         }
+    }
 
-        const int block_offset = (config_.layout.center_horizontally && content_width > static_cast<int>(max_v_width))
-            ? (content_width - static_cast<int>(max_v_width)) / 2
-            : 0;
+    void NavigationTUI::render_list_rows(const size_t row_count) {
+        frame_.items_row = layout_.items_row;
+        frame_.row_widths.clear();
+        frame_.row_widths.reserve(row_count);
 
-        for (size_t i = 0; i < items_to_render.size(); ++i) {
-            const auto& item = items_to_render[i];
-            const std::string highlight =
-                item.is_selected ? config_.theme.highlighted_prefix : std::string(highlight_v_w, ' ');
-
-            const std::string text_to_render = highlight + item.base_text;
-            TerminalUtils::move_cursor(items_start_row + static_cast<int>(i), left_padding + block_offset);
-
-            if (item.is_selected && config_.theme.use_colors &&
-                !(config_.theme.gradient_enabled && config_.theme.gradient_preset != extras::GradientPreset::NONE())) {
-                const std::string accent_color_code = get_color_sequence(config_.theme.palette.selected_item);
-                fmt::print("{}{}", accent_color_code, text_to_render);
-                TerminalUtils::reset_formatting();
-            } else if (item.is_selected && config_.theme.gradient_enabled &&
-                       config_.theme.gradient_preset != extras::GradientPreset::NONE()) {
-                apply_gradient_text(text_to_render, items_start_row + static_cast<int>(i), left_padding + block_offset);
-            } else {
-                fmt::print("{}", text_to_render);
-            }
+        for (size_t i = 0; i < row_count; ++i) {
+            const ListRow data = build_list_row(i);
+            draw_list_row(layout_.items_row + static_cast<int>(i), layout_.items_col, data);
+            frame_.row_widths.push_back(data.width);
         }
     }
 
+    void NavigationTUI::render_section_selection(const int start_row, const int left_padding, const int content_width) {
+        // Header
+        screen_.draw_text(start_row, left_padding,
+                          center_string(config_.text.section_selection_title, content_width).content);
+        const size_t title_width = TerminalUtils::get_visible_string_length(config_.text.section_selection_title);
+        screen_.draw_text(start_row + 1, left_padding,
+                          center_string(std::string(title_width, '='), content_width).content);
+
+        // Sections
+        render_list_rows(layout_.row_count);
+    }
+
     void NavigationTUI::render_item_selection(const int start_row, const int left_padding, const int content_width) {
         if (current_section_index_ >= sections_.size()) {
             return;
@@ -831,117 +1373,50 @@ namespace tui {
 
         // Header
         const std::string title = config_.text.item_selection_prefix + section.name;
-        TerminalUtils::move_cursor(start_row, left_padding);
-        fmt::print("{}", center_string(title, content_width).content);
-
-        TerminalUtils::move_cursor(start_row + 1, left_padding);
-        fmt::print("{}", center_string(std::string(title.length(), '='), content_width).content);
-
-        const int items_start_row = start_row + 2 + config_.layout.vertical_padding;
+        screen_.draw_text(start_row, left_padding, center_string(title, content_width).content);
+        screen_.draw_text(
+            start_row + 1, left_padding,
+            center_string(std::string(TerminalUtils::get_visible_string_length(title), '='), content_width).content);
 
         // Items
         if (section.empty()) {
-            TerminalUtils::move_cursor(items_start_row, left_padding);
-            fmt::print("{}", center_string(config_.text.empty_section_message, content_width).content);
+            screen_.draw_text(layout_.items_row, left_padding,
+                              center_string(config_.text.empty_section_message, content_width).content);
+            frame_.items_row = layout_.items_row;
             return;
         }
 
-        size_t max_v_width = 0;
-
-        struct ItemData {
-            const SelectableItem* item;
-            std::string display_text;
-            bool is_selected;
-        };
-        std::vector<ItemData> items;
-
-        auto [first, second] = get_current_page_bounds();
-        for (size_t i = first; i < second; ++i) {
-            const auto* item = section.get_item(i);
-            if (!item) {
-                continue;
-            }
-
-            const bool is_selected = (i - first) == current_selection_index_;
-            std::string display_text = format_item_with_theme(*item, is_selected);
-            size_t v_width = TerminalUtils::get_visible_string_length(display_text);
-
-            if (v_width > max_v_width) {
-                max_v_width = v_width;
-            }
+        render_list_rows(layout_.row_count);
+    }
 
-            items.push_back({item, display_text, is_selected});
+    const SelectableItem* NavigationTUI::get_current_item() const {
+        if (current_state_ != NavigationState::ITEM_SELECTION || current_section_index_ >= sections_.size()) {
+            return nullptr;
         }
 
-        const int block_offset = (config_.layout.center_horizontally && content_width > static_cast<int>(max_v_width))
-            ? (content_width - static_cast<int>(max_v_width)) / 2
-            : 0;
-
-        for (size_t i = 0; i < items.size(); ++i) {
-            const auto& data = items[i];
-            const int current_row = static_cast<int>(items_start_row + i);
-            TerminalUtils::move_cursor(current_row, left_padding + block_offset);
-
-            if (!data.is_selected) {
-                if (config_.theme.use_colors) {
-                    fmt::print("{}{}", get_color_sequence(config_.theme.palette.unselected_item), data.display_text);
-                    TerminalUtils::reset_formatting();
-                } else {
-                    fmt::print("{}", data.display_text);
-                }
-            } else if (config_.theme.gradient_enabled &&
-                       config_.theme.gradient_preset != extras::GradientPreset::NONE()) {
-                apply_gradient_text(data.display_text, current_row, left_padding + block_offset);
-            } else {
-                if (config_.theme.use_colors) {
-                    fmt::print("{}{}", get_color_sequence(config_.theme.palette.selected_item), data.display_text);
-                    TerminalUtils::reset_formatting();
-                } else {
-                    fmt::print("{}", data.display_text);
-                }
-            }
-        }
+        // Not bounded by the viewport, compute_layout() needs the item before it knows the viewport height
+        return sections_[current_section_index_].get_item(get_list_offset(current_state_) + current_selection_index_);
     }
 
-    void NavigationTUI::render_footer(const int term_height, const int left_padding, const int content_width,
-                                      const SelectableItem* item = nullptr) {
-        // footer (description)
-        std::string description;
-
+    std::string NavigationTUI::get_description_text(const SelectableItem* item) const {
         if (item) {
-            description = item->description.empty() ? "No description provided" : item->description;
-        } else if (current_state_ == NavigationState::MAIN_MENU) {
-            const auto start_index = current_section_page_ * config_.layout.sections_per_page;
-            const size_t global_index = start_index + current_selection_index_;
+            return item->description.empty() ? "No description provided" : item->description;
+        }
+
+        if (current_state_ == NavigationState::MAIN_MENU) {
+            const size_t global_index = get_list_offset(current_state_) + current_selection_index_;
 
             if (global_index < sections_.size()) {
                 const auto& section = sections_[global_index];
-                description = section.description.empty() ? "No description provided" : section.description;
-            } else {
-                description = "No section selected";
+                return section.description.empty() ? "No description provided" : section.description;
             }
-        } else {
-            description = "Description (placeholder)";
+            return "No section selected";
         }
 
-        auto [content, line_count] = center_string(description, content_width);
-
-        const int description_anchor_row = term_height - 4;
-        const int description_start_row = description_anchor_row - (line_count - 1);
-
-        TerminalUtils::move_cursor(description_start_row, left_padding);
-
-        std::istringstream stream(content);
-        std::string line;
-        int current_row = description_start_row;
-
-        while (std::getline(stream, line)) {
-            TerminalUtils::move_cursor(current_row, left_padding);
-            fmt::print("{}", line);
-            current_row++;
-        }
+        return "Description (placeholder)";
+    }
 
-        // footer (help text)
+    std::string NavigationTUI::get_help_text() const {
         std::string help_text = (current_state_ == NavigationState::MAIN_MENU) ? config_.text.help_text_sections
                                                                                : config_.text.help_text_items;
         if ((current_state_ == NavigationState::MAIN_MENU && config_.layout.paginate_sections &&
@@ -949,34 +1424,59 @@ namespace tui {
             (current_state_ == NavigationState::ITEM_SELECTION && config_.text.show_page_numbers)) {
             help_text += " | " + get_page_info_string();
         }
+        return help_text;
+    }
 
-        auto [help_content, help_line_count] = center_string(help_text, content_width);
-
-        const int help_anchor_row = term_height - 2;
-        const int help_start_row = help_anchor_row - (help_line_count - 1);
+    std::pair<int, int> NavigationTUI::get_footer_lines(const int content_width, const SelectableItem* item) const {
+        const bool center = config_.layout.center_horizontally;
+        const auto description_lines =
+            static_cast<int>(wrap_cache_.get(get_description_text(item), content_width, center).lines.size());
+        const auto help_lines = static_cast<int>(wrap_cache_.get(get_help_text(), content_width, center).lines.size());
 
-        TerminalUtils::move_cursor(help_start_row, left_padding);
+        return {description_lines, help_lines};
+    }
 
-        current_row = help_start_row;
-        std::istringstream help_stream(help_content);
-        while (std::getline(help_stream, line)) {
-            TerminalUtils::move_cursor(current_row, left_padding);
-            fmt::print("{}", line);
-            current_row++;
+    void NavigationTUI::draw_wrapped(const int top_row, const int left_padding, const WrappedText& wrapped) {
+        for (size_t i = 0; i < wrapped.lines.size(); ++i) {
+            screen_.draw_text(top_row + static_cast<int>(i), left_padding + wrapped.lines[i].indent, wrapped.line(i));
         }
     }
 
+    void NavigationTUI::render_footer(const int left_padding, const int content_width,
+                                      const SelectableItem* item = nullptr) {
+        const bool center = config_.layout.center_horizontally;
+
+        // footer (description), wrapped to the content width
+        draw_wrapped(layout_.description_row, left_padding,
+                     wrap_cache_.get(get_description_text(item), content_width, center));
+
+        // footer (help text)
+        draw_wrapped(layout_.help_row, left_padding, wrap_cache_.get(get_help_text(), content_width, center));
+
+        frame_.footer_top = layout_.footer_top;
+    }
+
     std::string NavigationTUI::format_item_with_theme(const SelectableItem& item, const bool is_selected) const {
-        const std::string prefix = item.selected ? config_.theme.selected_prefix : config_.theme.unselected_prefix;
-        const std::string highlight = is_selected
-            ? config_.theme.highlighted_prefix
-            : std::string(TerminalUtils::get_visible_string_length(config_.theme.highlighted_prefix), ' ');
-        std::string display_text = fmt::format("{}{} {}", highlight, prefix, item.name);
+        const std::string& prefix = item.selected ? theme_.selected_prefix : theme_.unselected_prefix;
+        const std::string& highlight = is_selected ? theme_.highlighted_prefix : theme_.highlight_padding;
+
+        std::string display_text;
+        display_text.reserve(highlight.size() + prefix.size() + 1 + item.name.size());
+        display_text += highlight;
+        display_text += prefix;
+        display_text += ' ';
+        display_text += item.name;
 
         return display_text;
     }
 
     std::string NavigationTUI::get_page_info_string() const {
+        if (config_.layout.scroll_lists) {
+            const size_t size = get_list_size(current_state_);
+            return fmt::format("{} {} of {}", (current_state_ == NavigationState::MAIN_MENU) ? "Section" : "Item",
+                               size > 0 ? get_list_offset(current_state_) + current_selection_index_ + 1 : 0, size);
+        }
+
         int total_pages = calculate_total_pages();
         return fmt::format(
             "Page {} of {}",
@@ -984,8 +1484,13 @@ namespace tui {
             total_pages);
     }
 
-    int NavigationTUI::calculate_total_pages() const {
-        if (current_state_ == NavigationState::MAIN_MENU) {
+    int NavigationTUI::calculate_total_pages(const NavigationState state) const {
+        if (config_.layout.scroll_lists) {
+            const size_t rows = get_viewport_rows(state);
+            return std::max(1, static_cast<int>((get_list_size(state) + rows - 1) / rows));
+        }
+
+        if (state == NavigationState::MAIN_MENU) {
             return (!config_.layout.paginate_sections || sections_.empty())
                 ? 1
                 : (static_cast<int>((sections_.size() + config_.layout.sections_per_page - 1)) /
@@ -1008,12 +1513,130 @@ namespace tui {
             return {0, 0};
         }
 
-        size_t start = current_page_ * config_.layout.items_per_page;
-        size_t end = std::min(start + config_.layout.items_per_page, sections_[current_section_index_].size());
+        size_t start = get_list_offset(current_state_);
+        size_t end = std::min(start + get_viewport_rows(current_state_), sections_[current_section_index_].size());
 
         return {start, end};
     }
 
+    size_t NavigationTUI::get_list_size(const NavigationState state) const {
+        if (state == NavigationState::MAIN_MENU) {
+            return sections_.size();
+        }
+        return (current_section_index_ < sections_.size()) ? sections_[current_section_index_].size() : 0;
+    }
+
+    size_t NavigationTUI::get_viewport_rows(const NavigationState state) const {
+        int rows = std::max(1, (state == NavigationState::MAIN_MENU) ? config_.layout.sections_per_page
+                                                                     : config_.layout.items_per_page);
+
+        if (config_.layout.scroll_lists && previous_height_ > 0) {
+            // Place a full viewport the way compute_layout() would and drop the rows that run into the footer
+            LayoutState layout;
+            layout.term_height = previous_height_;
+            layout.footer_top = previous_height_ - footer_height_ + 1;
+            layout.row_count = static_cast<size_t>(rows);
+            place_content(layout);
+
+            rows = std::max(1, rows - std::max(0, layout.content_bottom - (layout.footer_top - 1)));
+        }
+
+        return static_cast<size_t>(rows);
+    }
+
+    size_t NavigationTUI::get_list_offset(const NavigationState state) const {
+        if (config_.layout.scroll_lists) {
+            return (state == NavigationState::MAIN_MENU) ? section_offset_ : item_offset_;
+        }
+
+        return (state == NavigationState::MAIN_MENU)
+            ? static_cast<size_t>(current_section_page_) * static_cast<size_t>(config_.layout.sections_per_page)
+            : static_cast<size_t>(current_page_) * static_cast<size_t>(config_.layout.items_per_page);
+    }
+
+    int NavigationTUI::get_viewport_page(const NavigationState state) const {
+        if (!config_.layout.scroll_lists) {
+            return (state == NavigationState::MAIN_MENU) ? current_section_page_ : current_page_;
+        }
+
+        const size_t offset = get_list_offset(state);
+        const size_t rows = get_viewport_rows(state);
+        const size_t size = get_list_size(state);
+
+        // A viewport scrolled to the end counts as the last page even if it does not start on a page boundary
+        if (offset > 0 && offset + rows >= size) {
+            return static_cast<int>((size - 1) / rows);
+        }
+        return static_cast<int>(offset / rows);
+    }
+
+    void NavigationTUI::scroll_to(const NavigationState state, size_t offset) {
+        const size_t rows = get_viewport_rows(state);
+        const size_t size = get_list_size(state);
+        offset = std::min(offset, size > rows ? size - rows : 0);
+
+        size_t& current = (state == NavigationState::MAIN_MENU) ? section_offset_ : item_offset_;
+        if (offset == current) {
+            return;
+        }
+
+        const int previous_page = get_viewport_page(state);
+        const auto lines = static_cast<std::ptrdiff_t>(offset) - static_cast<std::ptrdiff_t>(current);
+        current = offset;
+
+        // The other list is not on screen, only its position changes
+        if (state == current_state_) {
+            invalidate_layout();
+            if (static_cast<size_t>(std::abs(lines)) < rows) {
+                pending_scroll_ += static_cast<int>(lines);
+            }
+            needs_redraw_ = true;
+        }
+
+        if (state == NavigationState::ITEM_SELECTION && on_page_changed_) {
+            if (const int page = get_viewport_page(state); page != previous_page) {
+                on_page_changed_(page, calculate_total_pages(state));
+                invalidate_screen();
+            }
+        }
+    }
+
+    void NavigationTUI::show_entry(const size_t index) {
+        const size_t rows = get_viewport_rows(current_state_);
+
+        if (!config_.layout.scroll_lists) {
+            invalidate_layout();
+            (current_state_ == NavigationState::MAIN_MENU ? current_section_page_ : current_page_) =
+                static_cast<int>(index / rows);
+            current_selection_index_ = index % rows;
+            return;
+        }
+
+        const size_t size = get_list_size(current_state_);
+        size_t& offset = (current_state_ == NavigationState::MAIN_MENU) ? section_offset_ : item_offset_;
+        invalidate_layout();
+
+        offset = std::min(offset, size > rows ? size - rows : 0);
+        if (index < offset) {
+            offset = index;
+        } else if (index >= offset + rows) {
+            offset = index - rows + 1;
+        }
+        current_selection_index_ = index - offset;
+    }
+
+    size_t NavigationTUI::get_selected_count(const size_t section_index) const {
+        if (selected_counts_.size() != sections_.size()) {
+            selected_counts_.assign(sections_.size(), std::string::npos);
+        }
+
+        size_t& count = selected_counts_[section_index];
+        if (count == std::string::npos) {
+            count = sections_[section_index].get_selected_count();
+        }
+        return count;
+    }
+
     void NavigationTUI::clamp_selection() {
         if (current_state_ == NavigationState::MAIN_MENU && current_section_index_ >= sections_.size()) {
             current_selection_index_ = !sections_.empty() ? sections_.size() - 1 : 0;
@@ -1029,9 +1652,12 @@ namespace tui {
         if (current_state_ != new_state) {
             const NavigationState old_state = current_state_;
             current_state_ = new_state;
+            pending_scroll_ = 0;
+            invalidate_layout();
 
             if (on_state_changed_) {
                 on_state_changed_(old_state, new_state);
+                invalidate_screen();
             }
         }
     }
@@ -1198,6 +1824,26 @@ namespace tui {
         return *this;
     }
 
+    NavigationBuilder& NavigationBuilder::layout_alternate_screen(const bool enable) {
+        config_.layout.use_alternate_screen = enable;
+        return *this;
+    }
+
+    NavigationBuilder& NavigationBuilder::layout_scrolling(const bool enable) {
+        config_.layout.scroll_lists = enable;
+        return *this;
+    }
+
+    NavigationBuilder& NavigationBuilder::layout_frame_rate(const int frames_per_second) {
+        config_.layout.frame_rate_limit = std::max(0, frames_per_second);
+        return *this;
+    }
+
+    NavigationBuilder& NavigationBuilder::layout_resize_debounce(const int milliseconds) {
+        config_.layout.resize_debounce_ms = std::max(0, milliseconds);
+        return *this;
+    }
+
     NavigationBuilder& NavigationBuilder::layout_items_per_page(const int count) {
         config_.layout.items_per_page = count;
         return *this;
@@ -1256,6 +1902,11 @@ namespace tui {
         return *this;
     }
 
+    NavigationBuilder& NavigationBuilder::keys_escape_timeout(const int milliseconds) {
+        config_.escape_timeout_ms = std::max(0, milliseconds);
+        return *this;
+    }
+
     NavigationBuilder& NavigationBuilder::keys_custom_shortcut(const char key, const std::string& description) {
         config_.custom_shortcuts[key] = description;
         return *this;
@@ -1311,6 +1962,21 @@ namespace tui {
         return *this;
     }
 
+    NavigationBuilder& NavigationBuilder::terminal_backend(std::shared_ptr<TerminalBackend> backend) {
+        terminal_backend_ = std::move(backend);
+        return *this;
+    }
+
+    NavigationBuilder& NavigationBuilder::render_stats(const bool enable) {
+        render_stats_ = enable;
+        return *this;
+    }
+
+    NavigationBuilder& NavigationBuilder::on_frame(NavigationTUI::FrameCallback callback) {
+        frame_callback_ = std::move(callback);
+        return *this;
+    }
+
     NavigationBuilder& NavigationBuilder::theme_minimal() {
         config_.theme.use_unicode = false;
         config_.theme.use_colors = false;
@@ -1420,6 +2086,15 @@ namespace tui {
         if (update_callback_) {
             tui->set_update_callback(update_callback_);
         }
+        if (terminal_backend_) {
+            tui->set_terminal_backend(terminal_backend_);
+        }
+        if (render_stats_) {
+            tui->enable_render_stats(true);
+        }
+        if (frame_callback_) {
+            tui->set_frame_callback(frame_callback_);
+        }
 
         return tui;
     }
@@ -1437,6 +2112,9 @@ namespace tui {
         exit_callback_ = nullptr;
         custom_command_callback_ = nullptr;
         update_callback_ = nullptr;
+        terminal_backend_ = nullptr;
+        frame_callback_ = nullptr;
+        render_stats_ = false;
 
         return *this;
     }
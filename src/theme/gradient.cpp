@@ -141,4 +141,39 @@ namespace tui::extras {
 
     bool GradientPreset::operator!=(const GradientPreset& other) const { return !(*this == other); }
 
+    GradientColor GradientColor::quantized(const uint8_t step) const {
+        if (step <= 1) {
+            return *this;
+        }
+
+        const auto round = [step](const uint8_t channel) {
+            const int value = (channel + step / 2) / step * step;
+            return static_cast<uint8_t>(value > 255 ? 255 : value);
+        };
+        return GradientColor{round(r_), round(g_), round(b_)};
+    }
+
+    ///
+    /// GradientCache implementation
+    ///
+    const std::vector<GradientColor>& GradientCache::get(const GradientPreset& preset, const int steps) {
+        for (const auto& entry : entries_) {
+            if (entry.steps == steps && entry.preset == preset) {
+                return entry.colors;
+            }
+        }
+
+        if (entries_.size() >= MAX_ENTRIES) {
+            entries_.erase(entries_.begin());
+        }
+
+        auto colors = GradientColor::from_preset(preset, steps);
+        for (auto& color : colors) {
+            color = color.quantized(QUANTIZATION_STEP);
+        }
+
+        entries_.push_back(Entry{preset, steps, std::move(colors)});
+        return entries_.back().colors;
+    }
+
 }; // namespace tui::extras
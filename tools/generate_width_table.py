@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Generate include/rebuildTUI/core/width_table.hpp from Python's unicodedata.
+
+Display width per code point:
+  0 - C0/C1 controls, nonspacing and enclosing marks (Mn, Me), format characters (Cf)
+      except the visible ones, Hangul medial vowels and final consonants
+  2 - East Asian Wide and Fullwidth characters, plus the unassigned CJK planes
+  1 - everything else (including East Asian Ambiguous)
+
+The table is two-level: STAGE1 maps the high bits of a code point to a block of
+256 widths in STAGE2, identical blocks are stored once. Each width takes two bits.
+
+Usage: tools/generate_width_table.py > include/rebuildTUI/core/width_table.hpp
+"""
+
+import sys
+import unicodedata
+
+MAX_CODE_POINT = 0x10FFFF
+BLOCK_SIZE = 256
+
+# Cf characters that still occupy a column
+VISIBLE_FORMAT = {0x00AD, 0x0600, 0x0601, 0x0602, 0x0603, 0x0604, 0x0605, 0x06DD, 0x070F, 0x0890, 0x0891,
+                  0x08E2, 0x110BD, 0x110CD}
+
+
+def width(cp):
+    if cp < 0x20 or 0x7F <= cp < 0xA0:
+        return 0
+    if 0x1160 <= cp <= 0x11FF or 0xD7B0 <= cp <= 0xD7FF:
+        return 0
+    if 0x20000 <= cp <= 0x2FFFD or 0x30000 <= cp <= 0x3FFFD:
+        return 2
+
+    ch = chr(cp)
+    category = unicodedata.category(ch)
+    if category in ('Mn', 'Me') or (category == 'Cf' and cp not in VISIBLE_FORMAT):
+        return 0
+    if unicodedata.east_asian_width(ch) in ('W', 'F'):
+        return 2
+    return 1
+
+
+def main():
+    blocks = []
+    block_index = {}
+    stage1 = []
+
+    for start in range(0, MAX_CODE_POINT + 1, BLOCK_SIZE):
+        widths = tuple(width(cp) for cp in range(start, start + BLOCK_SIZE))
+        if widths not in block_index:
+            block_index[widths] = len(blocks)
+            blocks.append(widths)
+        stage1.append(block_index[widths])
+
+    if len(blocks) > 256:
+        sys.exit(f'{len(blocks)} distinct blocks do not fit into uint8_t indices')
+
+    stage2 = []
+    for widths in blocks:
+        for i in range(0, BLOCK_SIZE, 4):
+            stage2.append(widths[i] | widths[i + 1] << 2 | widths[i + 2] << 4 | widths[i + 3] << 6)
+
+    def rows(values, per_line):
+        for i in range(0, len(values), per_line):
+            yield '        ' + ', '.join(f'0x{v:02X}' for v in values[i:i + per_line]) + ','
+
+    out = []
+    out.append('#pragma once')
+    out.append('')
+    out.append(f'// Generated by tools/generate_width_table.py from Unicode {unicodedata.unidata_version}, do not edit.')
+    out.append('')
+    out.append('#include <cstdint>')
+    out.append('')
+    out.append('namespace tui::unicode::detail {')
+    out.append('')
+    out.append(f'    inline constexpr uint32_t WIDTH_BLOCK_SHIFT = {BLOCK_SIZE.bit_length() - 1};')
+    out.append(f'    inline constexpr uint32_t WIDTH_BLOCK_COUNT = {len(blocks)};')
+    out.append('')
+    out.append('    /// Block index for each 256 code point range')
+    out.append(f'    inline constexpr uint8_t WIDTH_STAGE1[{len(stage1)}] = {{')
+    out.extend(rows(stage1, 16))
+    out.append('    };')
+    out.append('')
+    out.append('    /// Widths of each distinct block, four 2-bit entries per byte')
+    out.append(f'    inline constexpr uint8_t WIDTH_STAGE2[{len(stage2)}] = {{')
+    out.extend(rows(stage2, 16))
+    out.append('    };')
+    out.append('')
+    out.append('} // namespace tui::unicode::detail')
+    print('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()